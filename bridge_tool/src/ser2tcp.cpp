@@ -0,0 +1,176 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <CppSerialPort/SerialPort.hpp>
+#include <CppSerialPort/TcpServer.hpp>
+#include <CppSerialPort/StreamBridge.hpp>
+
+using CppSerialPort::StreamBridge;
+
+std::vector<std::string> optionPrefixes{"--", "-"};
+std::vector<std::string> baudRateOptions{"b", "baud"};
+std::vector<std::string> bindOptions{"a", "bind"};
+std::vector<std::string> intervalOptions{"i", "interval"};
+std::vector<std::string> noSpliceOptions{"n", "no-splice"};
+std::vector<std::string> onceOptions{"o", "once"};
+std::vector<std::string> helpOptions{"h", "help"};
+
+std::map<int, CppSerialPort::BaudRate> baudRates{
+    {1200, CppSerialPort::BaudRate::Baud1200},
+    {2400, CppSerialPort::BaudRate::Baud2400},
+    {4800, CppSerialPort::BaudRate::Baud4800},
+    {9600, CppSerialPort::BaudRate::Baud9600},
+    {19200, CppSerialPort::BaudRate::Baud19200},
+    {38400, CppSerialPort::BaudRate::Baud38400},
+    {57600, CppSerialPort::BaudRate::Baud57600},
+    {115200, CppSerialPort::BaudRate::Baud115200},
+    {230400, CppSerialPort::BaudRate::Baud230400},
+    {460800, CppSerialPort::BaudRate::Baud460800},
+    {921600, CppSerialPort::BaudRate::Baud921600}
+};
+
+CppSerialPort::BaudRate baudRate{CppSerialPort::SerialPort::DEFAULT_BAUD_RATE};
+std::string bindAddress{""};
+int statisticsInterval{10};
+bool useSplice{true};
+bool acceptOnce{false};
+
+bool matchesOption(const std::string &option, const std::vector<std::string> &options);
+void printUsage(const char *programName);
+std::string describeDirection(const std::string &name, const StreamBridge::DirectionStatistics &statistics);
+void printStatistics(const StreamBridge &bridge);
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> positionalArguments{};
+    for (int i = 1; i < argc; i++) {
+        std::string temp{argv[i]};
+        std::string copy{temp};
+
+        //To lower case
+        std::transform(temp.begin(), temp.end(), temp.begin(), ::tolower);
+
+        //Strip off option prefixes
+        bool isOption{false};
+        for (const auto &it : optionPrefixes) {
+            if (temp.rfind(it, 0) == 0) {
+                temp = temp.substr(it.length());
+                isOption = true;
+                break;
+            }
+        }
+        if (!isOption) {
+            positionalArguments.push_back(copy);
+            continue;
+        }
+
+        try {
+            if (matchesOption(temp, helpOptions)) {
+                printUsage(argv[0]);
+                return 0;
+            } else if (matchesOption(temp, noSpliceOptions)) {
+                useSplice = false;
+            } else if (matchesOption(temp, onceOptions)) {
+                acceptOnce = true;
+            } else if (i + 1 >= argc) {
+                std::cout << "Option \"" << copy << "\" needs a value" << std::endl;
+                return 1;
+            } else if (matchesOption(temp, baudRateOptions)) {
+                auto found = baudRates.find(std::stoi(argv[++i]));
+                if (found == baudRates.end()) {
+                    std::cout << "Unsupported baud rate \"" << argv[i] << "\"" << std::endl;
+                    return 1;
+                }
+                baudRate = found->second;
+            } else if (matchesOption(temp, bindOptions)) {
+                bindAddress = argv[++i];
+            } else if (matchesOption(temp, intervalOptions)) {
+                statisticsInterval = std::stoi(argv[++i]);
+            } else {
+                std::cout << "Unknown option \"" << copy << "\"" << std::endl;
+            }
+        } catch (const std::exception &e) {
+            std::cout << "Invalid value \"" << argv[i] << "\" for option \"" << copy << "\"" << std::endl;
+            return 1;
+        }
+    }
+    if (positionalArguments.size() != 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    //A client dropping mid-splice would otherwise kill the process with SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+
+    try {
+        CppSerialPort::SerialPort serialPort{positionalArguments[0], baudRate};
+        serialPort.openPort();
+        CppSerialPort::TcpServer server{static_cast<uint16_t>(std::stoi(positionalArguments[1])), bindAddress};
+        server.listen();
+        std::cout << "Bridging " << serialPort.portName() << " to TCP port " << server.portNumber() << std::endl;
+        do {
+            auto client = server.accept(std::chrono::steady_clock::now() + std::chrono::hours{24});
+            if (!client) {
+                continue;
+            }
+            std::cout << "Client connected from " << client->portName() << std::endl;
+            StreamBridge bridge{serialPort, *client};
+            bridge.setSpliceEnabled(useSplice);
+            bridge.start();
+            auto nextReport = std::chrono::steady_clock::now() + std::chrono::seconds{statisticsInterval};
+            while (bridge.isRunning()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{100});
+                if ( (statisticsInterval > 0) && (std::chrono::steady_clock::now() >= nextReport) ) {
+                    printStatistics(bridge);
+                    nextReport += std::chrono::seconds{statisticsInterval};
+                }
+            }
+            bridge.stop();
+            printStatistics(bridge);
+            if (!bridge.error().empty()) {
+                std::cout << "Bridge stopped: " << bridge.error() << std::endl;
+                if (!serialPort.isOpen()) {
+                    return 1;
+                }
+            }
+            std::cout << "Client " << client->portName() << " disconnected" << std::endl;
+        } while (!acceptOnce);
+    } catch (const std::exception &e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+bool matchesOption(const std::string &option, const std::vector<std::string> &options) {
+    return std::find(options.begin(), options.end(), option) != options.end();
+}
+
+void printUsage(const char *programName) {
+    std::cout << "Usage: " << programName << " [options] <serial port> <tcp port>" << std::endl;
+    std::cout << "    -b, --baud <rate>         Serial baud rate (default 9600)" << std::endl;
+    std::cout << "    -a, --bind <address>      Address to listen on (default all)" << std::endl;
+    std::cout << "    -i, --interval <seconds>  Print statistics this often, 0 for only on disconnect (default 10)" << std::endl;
+    std::cout << "    -n, --no-splice           Always copy through a buffer instead of splicing" << std::endl;
+    std::cout << "    -o, --once                Exit after the first client disconnects" << std::endl;
+}
+
+std::string describeDirection(const std::string &name, const StreamBridge::DirectionStatistics &statistics) {
+    std::stringstream description{};
+    description << name << ": " << statistics.bytes << " bytes in " << statistics.transfers << " transfers, "
+                << std::fixed << std::setprecision(1) << (statistics.bytesPerSecond / 1024.0) << " KiB/s, latency avg "
+                << statistics.averageLatency.count() << "us max " << statistics.maximumLatency.count() << "us ("
+                << ( (statistics.mode == StreamBridge::TransferMode::Splice) ? "splice" : "buffered" ) << ")";
+    return description.str();
+}
+
+void printStatistics(const StreamBridge &bridge) {
+    std::cout << describeDirection("serial -> tcp", bridge.statistics(StreamBridge::Direction::FirstToSecond)) << std::endl;
+    std::cout << describeDirection("tcp -> serial", bridge.statistics(StreamBridge::Direction::SecondToFirst)) << std::endl;
+}
@@ -18,6 +18,8 @@ typedef int socket_t;
 #include <string>
 #include "IByteStream.hpp"
 #include "IPV4Address.hpp"
+#include "SocketOptions.hpp"
+#include "HostResolver.hpp"
 
 namespace CppSerialPort {
 
@@ -52,11 +54,13 @@ namespace CppSerialPort {
         AbstractSocket(const IPV4Address &ipAddress, uint16_t portNumber);
         ~AbstractSocket() override;
 
+        using IByteStream::write;
         ssize_t write(const char *bytes, size_t byteCount) override;
-        char read(bool *readTimeout) override;
+        ByteArray readAvailable() override;
         size_t rawRead(char *buffer, size_t max);
         ssize_t write(char i) override;
         std::string portName() const override;
+        int fileDescriptor() const override;
         bool isOpen() const override;
         void openPort() override;
         void closePort() override;
@@ -66,6 +70,11 @@ namespace CppSerialPort {
 
         void connect(const std::string &hostName, uint16_t portNumber);
         void connect();
+        void connect(std::chrono::steady_clock::time_point deadline);
+        void setConnectTimeout(std::chrono::microseconds timeout);
+        std::chrono::microseconds connectTimeout() const;
+        //Looks up this socket's host in the background, so a following connect() finds it cached
+        std::shared_future<HostResolution> resolveAsync();
         bool disconnect();
         bool isConnected() const;
         void setPortNumber(uint16_t portNumber);
@@ -80,34 +89,74 @@ namespace CppSerialPort {
         bool isBroadcasting() const;
         void setBroadcast(bool broadcast);
 
-        void setReadTimeout(int timeout) override;
-        void setWriteTimeout(int timeout) override;
+        //Options are kept and applied to every socket this object creates, before it connects
+        //On a connected socket they also take effect immediately
+        void setSocketOptions(const SocketOptions &options);
+        const SocketOptions &socketOptions() const;
+        int socketOption(int level, int name) const;
+        //Tags every chunk read with when the kernel (or network card) received it, see IByteStream::readChunk()
+        //For TCP a chunk carries the timestamp of the newest segment it contains
+        void setReceiveTimestamping(ReceiveTimestamping timestamping);
+        ReceiveTimestamping receiveTimestamping() const;
+
+        using IByteStream::setReadTimeout;
+        using IByteStream::setWriteTimeout;
+        void setReadTimeout(std::chrono::microseconds timeout) override;
+        void setWriteTimeout(std::chrono::microseconds timeout) override;
 
         static const uint16_t MINIMUM_PORT_NUMBER;
         static const uint16_t MAXIMUM_PORT_NUMBER;
+        static const std::chrono::microseconds DEFAULT_CONNECT_TIMEOUT;
+#if !defined(_WIN32)
+        static const size_t RECEIVE_TIMESTAMP_CONTROL_SIZE;
+#endif //!defined(_WIN32)
 private:
         socket_t m_socketDescriptor;
         addrinfo m_addressInfo;
+        sockaddr_storage m_peerAddress;
         std::string m_hostName;
         uint16_t m_portNumber;
-        ByteArray m_readBuffer;
         bool m_isBound;
+        SocketOptions m_socketOptions;
+        std::chrono::microseconds m_connectTimeout;
 
 protected:
+        AbstractSocket(socket_t socketDescriptor, const sockaddr *peerAddress, socklen_t peerAddressLength);
+        //For sockets addressed by a local name (a path) instead of a host and port
+        explicit AbstractSocket(const std::string &localName);
+
         virtual ssize_t doRead(char *buffer, size_t bufferMax) = 0;
         virtual ssize_t doWrite(const char *bytes, size_t numberOfBytes) = 0;
+        virtual ssize_t doWrite(const ConstBuffer *buffers, size_t count) = 0;
         virtual void doConnect() = 0;
         virtual addrinfo getAddressInfoHints() = 0;
+        //Turns the host name and port into addresses to connect to. The default looks them up with HostResolver
+        virtual std::shared_ptr<const std::vector<ResolvedAddress>> resolveAddresses(const addrinfo &hints);
+        size_t readFromDevice(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) override;
+        ssize_t writeBuffers(const ConstBuffer *buffers, size_t count) override;
 
         const addrinfo *addressInfo();
 
         static timeval toTimeVal(uint32_t totalTimeout);
+        static timeval toTimeVal(std::chrono::microseconds totalTimeout);
         bool isDisconnected() const;
+        bool waitForReadable(std::chrono::steady_clock::time_point deadline);
         socket_t socketDescriptor() const;
         void setSocketDescriptor(socket_t socketDescriptor);
         ssize_t checkAvailable();
 
+#if !defined(_WIN32)
+        //recv() that also picks up the receive timestamp for the chunk, for doRead() to use while timestamping
+        ssize_t receiveTimestamped(char *buffer, size_t bufferMax);
+        static ReceiveTimestamp receiveTimestampFrom(const msghdr &message);
+#endif //!defined(_WIN32)
+
         void setBlockingFlag(bool blocking);
+        void applySocketOptions(const SocketOptions &options);
+        void connectTo(const ResolvedAddress &address);
+        //Connects to one of the addresses by the deadline, or throws. The default tries them one after another
+        virtual void connectToAny(const std::vector<ResolvedAddress> &addresses, std::chrono::steady_clock::time_point deadline);
+        void adoptConnection(socket_t socketDescriptor, const ResolvedAddress &address);
 };
 
 } //namespace CppSerialPort
@@ -0,0 +1,66 @@
+#ifndef CPPSERIALPORT_BYTERINGBUFFER_HPP
+#define CPPSERIALPORT_BYTERINGBUFFER_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "ByteArray.hpp"
+
+namespace CppSerialPort {
+
+//Growable circular byte buffer, used as the read buffer for streams
+//Bytes are appended at the back and consumed from the front in O(1),
+//so draining a large receive does not shift the remaining contents
+class ByteRingBuffer {
+public:
+    ByteRingBuffer();
+    explicit ByteRingBuffer(size_t initialCapacity);
+    ByteRingBuffer(const ByteRingBuffer &) = default;
+    ByteRingBuffer(ByteRingBuffer &&) noexcept = default;
+    ByteRingBuffer &operator=(const ByteRingBuffer &) = default;
+    ByteRingBuffer &operator=(ByteRingBuffer &&) noexcept = default;
+    ~ByteRingBuffer() = default;
+
+    ByteRingBuffer &append(char c);
+    ByteRingBuffer &append(const char *bytes, size_t length);
+    ByteRingBuffer &append(const ByteArray &byteArray);
+    std::pair<char *, size_t> writeSpan(size_t minimum);
+    ByteRingBuffer &commitWrite(size_t count);
+
+    size_t peek(char *buffer, size_t maximum) const;
+    size_t read(char *buffer, size_t maximum);
+    ByteArray read(size_t maximum);
+    ByteRingBuffer &consume(size_t count);
+    char front() const;
+    char takeFront();
+
+    std::pair<const char *, size_t> frontSpan() const;
+    const char *linearize();
+    size_t find(char c, size_t from = 0) const;
+    size_t find(const char *pattern, size_t length, size_t from = 0) const;
+    size_t find(const ByteArray &pattern, size_t from = 0) const;
+
+    const char &operator[](size_t index) const;
+    const char &at(size_t index) const;
+
+    ByteRingBuffer &clear();
+    ByteRingBuffer &reserve(size_t capacity);
+    size_t size() const;
+    size_t length() const;
+    size_t capacity() const;
+    bool empty() const;
+
+    static const size_t DEFAULT_CAPACITY;
+
+private:
+    std::vector<char> m_buffer;
+    size_t m_head;
+    size_t m_size;
+
+    size_t physicalIndex(size_t index) const;
+    void grow(size_t minimumCapacity);
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_BYTERINGBUFFER_HPP
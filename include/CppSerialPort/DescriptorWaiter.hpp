@@ -0,0 +1,40 @@
+#ifndef CPPSERIALPORT_DESCRIPTORWAITER_HPP
+#define CPPSERIALPORT_DESCRIPTORWAITER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace CppSerialPort {
+
+//Waits for one descriptor to become ready, with ppoll() on Linux, poll() on other POSIX systems and WSAPoll() on Windows
+//Unlike select(), neither the cost nor the correctness of a wait depends on how large the descriptor number is
+class DescriptorWaiter
+{
+public:
+#if defined(_WIN32)
+    using descriptor_t = uintptr_t;
+#else
+    using descriptor_t = int;
+#endif //defined(_WIN32)
+
+    DescriptorWaiter() = delete;
+
+    //True once the descriptor is ready, or has hung up or failed, so the next call on it will not block
+    static bool waitForReadable(descriptor_t descriptor, std::chrono::steady_clock::time_point deadline);
+    static bool waitForWritable(descriptor_t descriptor, std::chrono::steady_clock::time_point deadline);
+    //Returns the poll() revents for the descriptor, or 0 if the deadline passed first
+    static short wait(descriptor_t descriptor, short events, std::chrono::steady_clock::time_point deadline);
+    //Waits for any of several descriptors, returning how many are ready (0 if the deadline passed first)
+    static size_t waitForAny(const descriptor_t *descriptors, size_t count, short events, std::chrono::steady_clock::time_point deadline);
+    //Waits with different events for each descriptor, filling in each one's revents (all 0 if the deadline passed first)
+    static size_t waitForEach(const descriptor_t *descriptors, const short *events, short *returnedEvents, size_t count, std::chrono::steady_clock::time_point deadline);
+
+private:
+    //Takes an array of pollfd (WSAPOLLFD on Windows), which this header does not pull in
+    static size_t pollDescriptors(void *pollDescriptorList, size_t count, std::chrono::steady_clock::time_point deadline);
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_DESCRIPTORWAITER_HPP
@@ -0,0 +1,65 @@
+#ifndef CPPSERIALPORT_GAPFRAMER_HPP
+#define CPPSERIALPORT_GAPFRAMER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include "ByteArray.hpp"
+#include "IByteStream.hpp"
+
+namespace CppSerialPort {
+
+//Splits a stream into frames separated by idle gaps on the line, as Modbus RTU does with its 3.5 character silence
+//Frames are built from whole chunks (see IByteStream::readChunk()), so each read takes everything the driver has
+//instead of polling byte by byte. With timestamped capture on (SerialPort::setTimestampedCapture()) gaps are measured
+//between the chunks' own timestamps, otherwise from when each chunk is handed over
+//Timing is only as fine as the driver's delivery; bytes the driver hands over together always land in one frame
+class GapFramer
+{
+public:
+    struct Frame {
+        ByteArray data;
+        std::chrono::steady_clock::time_point firstChunk;
+        std::chrono::steady_clock::time_point lastChunk;
+    };
+
+    GapFramer(IByteStream &stream, std::chrono::microseconds gap);
+    GapFramer(const GapFramer &) = delete;
+    GapFramer(GapFramer &&) = delete;
+    GapFramer &operator=(const GapFramer &) = delete;
+    GapFramer &operator=(GapFramer &&) = delete;
+    ~GapFramer() = default;
+
+    //Returns the next frame once the line has been idle for the gap. If the deadline passes first the bytes
+    //gathered so far are kept for the next call, and an empty frame is returned with timeout set
+    Frame readFrame(bool *timeout);
+    Frame readFrame(std::chrono::steady_clock::time_point deadline, bool *timeout);
+    //Drops a partially gathered frame, e.g. after a protocol error
+    void reset();
+
+    void setGap(std::chrono::microseconds gap);
+    std::chrono::microseconds gap() const;
+    void setMaximumFrameSize(size_t maximumFrameSize);
+    size_t maximumFrameSize() const;
+
+    //Time on the line for one character, at 11 bits (start, 8 data, parity or second stop, stop) by default
+    static std::chrono::microseconds characterTime(uint32_t baudRate, unsigned int bitsPerCharacter = 11);
+    //3.5 characters, fixed at 1750us above 19200 baud as the Modbus serial line specification allows
+    static std::chrono::microseconds modbusRtuGap(uint32_t baudRate);
+
+    static const size_t DEFAULT_MAXIMUM_FRAME_SIZE;
+
+private:
+    IByteStream &m_stream;
+    std::chrono::microseconds m_gap;
+    size_t m_maximumFrameSize;
+    Frame m_frame;
+    TimestampedChunk m_heldChunk;
+    bool m_hasHeldChunk;
+
+    bool addChunk(const ByteArray &data, std::chrono::steady_clock::time_point received);
+    Frame takeFrame();
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_GAPFRAMER_HPP
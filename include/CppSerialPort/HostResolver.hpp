@@ -0,0 +1,100 @@
+#ifndef CPPSERIALPORT_HOSTRESOLVER_HPP
+#define CPPSERIALPORT_HOSTRESOLVER_HPP
+
+#if defined(_WIN32)
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+#else
+#    include <sys/socket.h>
+#    include <netdb.h>
+#endif //defined(_WIN32)
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CppSerialPort {
+
+//One address returned by getaddrinfo(), copied out so it outlives freeaddrinfo()
+struct ResolvedAddress {
+    int family;
+    int socketType;
+    int protocol;
+    sockaddr_storage address;
+    socklen_t addressLength;
+};
+
+struct HostResolution {
+    //Null when the lookup failed, in which case error says why
+    std::shared_ptr<const std::vector<ResolvedAddress>> addresses;
+    std::string error;
+    std::chrono::steady_clock::time_point completedAt;
+};
+
+//Caches getaddrinfo() results, since reconnecting should not have to wait on DNS every time
+//getaddrinfo() does not report record TTLs, so every entry lives for the configured time to live
+//After that, the stale addresses keep being served (for up to maximumStaleness) while a refresh runs in the background,
+//and a failed refresh keeps the stale addresses instead of replacing them with the failure
+//Failures are cached too (for negativeTimeToLive), so a broken name is not looked up on every connect
+class HostResolver
+{
+public:
+    HostResolver();
+    HostResolver(const HostResolver &) = delete;
+    HostResolver(HostResolver &&) = delete;
+    HostResolver &operator=(const HostResolver &) = delete;
+    HostResolver &operator=(HostResolver &&) = delete;
+    ~HostResolver() = default;
+
+    //Shared by every socket in the process
+    static HostResolver &instance();
+
+    //Blocks only when nothing usable is cached, throws when the name cannot be resolved
+    std::shared_ptr<const std::vector<ResolvedAddress>> resolve(const std::string &hostName, uint16_t portNumber, const addrinfo &hints);
+    //Never blocks: cached results come back as a ready future, anything else is looked up on another thread
+    std::shared_future<HostResolution> resolveAsync(const std::string &hostName, uint16_t portNumber, const addrinfo &hints);
+
+    void invalidate(const std::string &hostName);
+    void clear();
+    size_t size() const;
+
+    void setTimeToLive(std::chrono::seconds timeToLive);
+    std::chrono::seconds timeToLive() const;
+    void setNegativeTimeToLive(std::chrono::seconds negativeTimeToLive);
+    std::chrono::seconds negativeTimeToLive() const;
+    void setMaximumStaleness(std::chrono::seconds maximumStaleness);
+    std::chrono::seconds maximumStaleness() const;
+
+    static const std::chrono::seconds DEFAULT_TIME_TO_LIVE;
+    static const std::chrono::seconds DEFAULT_NEGATIVE_TIME_TO_LIVE;
+    static const std::chrono::seconds DEFAULT_MAXIMUM_STALENESS;
+
+private:
+    struct Entry {
+        std::string hostName;
+        HostResolution resolution;
+        bool hasResolution{false};
+        std::chrono::steady_clock::time_point expiresAt;
+        std::chrono::steady_clock::time_point staleUntil;
+        std::shared_future<HostResolution> pending;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::chrono::seconds m_timeToLive;
+    std::chrono::seconds m_negativeTimeToLive;
+    std::chrono::seconds m_maximumStaleness;
+
+    void collect(Entry &entry);
+    static HostResolution lookup(const std::string &hostName, uint16_t portNumber, const addrinfo &hints);
+    static std::string makeKey(const std::string &hostName, uint16_t portNumber, const addrinfo &hints);
+    static std::shared_future<HostResolution> makeReady(const HostResolution &resolution);
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_HOSTRESOLVER_HPP
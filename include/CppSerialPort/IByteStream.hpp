@@ -1,10 +1,16 @@
 #ifndef CPPSERIALPORT_IBYTESTREAM_HPP
 #define CPPSERIALPORT_IBYTESTREAM_HPP
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
 #include <mutex>
 #include <string>
 #include <sstream>
+#include <vector>
 #include "ByteArray.hpp"
+#include "ByteRingBuffer.hpp"
 
 #if defined(_WIN32)
 #    ifndef PATH_MAX
@@ -17,18 +23,52 @@
 
 namespace CppSerialPort {
 
+//Non-owning view of bytes to be written, so several pieces can go out in one vectored write
+struct ConstBuffer {
+    ConstBuffer(const char *bytes, size_t byteCount) : data{bytes}, length{byteCount} {}
+    ConstBuffer(const ByteArray &byteArray) : data{byteArray.data()}, length{byteArray.length()} {}
+    ConstBuffer(const std::string &str) : data{str.data()}, length{str.length()} {}
+
+    const char *data;
+    size_t length;
+};
+
+//When a chunk of received bytes arrived. system is the kernel's receive time on the system clock,
+//hardware the network card's raw clock, both counted from their epoch. steady is when the read
+//that returned the chunk completed. Any of them is zero (the clock's epoch) when not available
+struct ReceiveTimestamp {
+    std::chrono::nanoseconds system;
+    std::chrono::nanoseconds hardware;
+    std::chrono::steady_clock::time_point steady;
+};
+
+struct TimestampedChunk {
+    ByteArray data;
+    ReceiveTimestamp timestamp;
+};
+
 class IByteStream
 {
 public:
     IByteStream();
     virtual ~IByteStream() = default;
 
-	virtual char read(bool *timeout) = 0;
+	virtual char read(bool *timeout);
+	size_t read(char *buffer, size_t maximum, bool *timeout);
+	size_t read(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline, bool *timeout);
+	size_t tryRead(char *buffer, size_t maximum);
+	size_t readExactly(char *buffer, size_t count, bool *timeout);
+	size_t readExactly(char *buffer, size_t count, std::chrono::steady_clock::time_point deadline, bool *timeout);
+	virtual ByteArray readAvailable();
 	virtual ssize_t write(char) = 0;
 	virtual ssize_t write(const char *, size_t) = 0;
 	virtual ssize_t write(const ByteArray &byteArray);
+	ssize_t write(const std::string &str);
+	ssize_t write(std::initializer_list<ConstBuffer> buffers);
+	ssize_t write(const std::vector<ConstBuffer> &buffers);
 
 	virtual std::string portName() const = 0;
+	virtual int fileDescriptor() const;
 	virtual bool isOpen() const = 0;
 	virtual void openPort() = 0;
 	virtual void closePort() = 0;
@@ -36,11 +76,15 @@ public:
 	virtual void flushTx() = 0;
 
 	virtual size_t available() = 0;
-	virtual void setReadTimeout(int timeout);
+	void setReadTimeout(int timeout);
+	virtual void setReadTimeout(std::chrono::microseconds timeout);
 	int readTimeout() const;
+	std::chrono::microseconds readTimeoutDuration() const;
 
-	virtual void setWriteTimeout(int timeout);
+	void setWriteTimeout(int timeout);
+	virtual void setWriteTimeout(std::chrono::microseconds timeout);
 	int writeTimeout() const;
+	std::chrono::microseconds writeTimeoutDuration() const;
 
 	ByteArray lineEnding() const;
 	void setLineEnding(const std::string &str);
@@ -51,11 +95,33 @@ public:
     virtual ssize_t writeLine(const ByteArray &byteArray);
 
     virtual ByteArray readLine(bool *timeout);
+    ByteArray readLine(std::chrono::steady_clock::time_point deadline, bool *timeout);
 	virtual ByteArray readUntil(const ByteArray &until, bool *timeout);
+	ByteArray readUntil(const ByteArray &until, std::chrono::steady_clock::time_point deadline, bool *timeout);
     virtual ByteArray readUntil(const std::string &until, bool *timeout);
     virtual ByteArray readUntil(char until, bool *timeout);
 
+    //With chunk timestamps enabled (see the stream's own setter), returns the bytes of the
+    //oldest buffered receive, tagged with when it arrived. Otherwise returns everything buffered
+    TimestampedChunk readChunk(bool *timeout);
+    TimestampedChunk readChunk(std::chrono::steady_clock::time_point deadline, bool *timeout);
+    ReceiveTimestamp frontTimestamp() const;
+
 protected:
+	virtual size_t readFromDevice(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) = 0;
+	virtual ssize_t writeBuffers(const ConstBuffer *buffers, size_t count);
+	size_t readWithin(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline, bool *timedOut);
+	size_t fillReadBuffer(std::chrono::steady_clock::time_point deadline);
+	//Counts bytes written into readBuffer().writeSpan(), so chunk timestamps stay lined up with the buffer
+	void commitReadBuffer(size_t count);
+	ByteRingBuffer &readBuffer();
+	const ByteRingBuffer &readBuffer() const;
+	//While enabled, reads always go through the read buffer, and every chunk readFromDevice()
+	//returns is tagged with the timestamp it last passed to setLastReceiveTimestamp()
+	void setChunkTimestamping(bool chunkTimestamping);
+	bool isChunkTimestamping() const;
+	void setLastReceiveTimestamp(const ReceiveTimestamp &timestamp);
+
 	static bool fileExists(const std::string &filePath);
 
 	template<typename T> static inline std::string toStdString(const T &t) {
@@ -78,20 +144,32 @@ protected:
 
 	static const int DEFAULT_READ_TIMEOUT;
 	static const int DEFAULT_WRITE_TIMEOUT;
+	static std::chrono::steady_clock::time_point deadlineAfter(std::chrono::microseconds timeout);
+	static const size_t constexpr READ_CHUNK_SIZE{8192};
 	static int64_t getEpoch();
 
 
 private:
-    int m_readTimeout;
-    int m_writeTimeout;
+    struct ChunkTimestamp {
+        uint64_t end;
+        ReceiveTimestamp timestamp;
+    };
+
+    std::chrono::microseconds m_readTimeout;
+    std::chrono::microseconds m_writeTimeout;
     ByteArray m_lineEnding;
+    ByteRingBuffer m_readBuffer;
     std::mutex m_writeMutex;
 	std::mutex m_readMutex;
+	bool m_chunkTimestamping;
+	std::deque<ChunkTimestamp> m_chunkTimestamps;
+	uint64_t m_bufferedByteCount;
+	ReceiveTimestamp m_lastReceiveTimestamp;
 
+	uint64_t consumedByteCount() const;
+	void discardConsumedTimestamps();
 
     static const char *DEFAULT_LINE_ENDING;
-
-    ssize_t write(const std::string &str);
 };
 
 } //namespace CppSerialPort
@@ -0,0 +1,86 @@
+#ifndef CPPSERIALPORT_IOURING_HPP
+#define CPPSERIALPORT_IOURING_HPP
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace CppSerialPort {
+
+//Minimal io_uring instance driven through the raw system calls, so there is no dependency on liburing
+//Submissions are queued with nextSubmission() and all go to the kernel in one submitAndWait(), and completions are
+//read straight out of the shared completion ring by reapCompletions() without any system call
+//Not thread safe: one thread owns the ring
+class IoUring
+{
+public:
+    explicit IoUring(unsigned entries, unsigned flags = 0);
+    IoUring(const IoUring &) = delete;
+    IoUring(IoUring &&) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+    IoUring &operator=(IoUring &&) = delete;
+    ~IoUring();
+
+    //False when the kernel is too old, or io_uring is disabled (kernel.io_uring_disabled, seccomp)
+    static bool isSupported();
+
+    //Zeroed entry to fill in, or nullptr when the submission ring is full (submit first)
+    io_uring_sqe *nextSubmission();
+    unsigned pendingSubmissions() const;
+    unsigned spaceLeft() const;
+    //Hands every queued submission to the kernel, then waits until waitFor completions are ready or timeout (ms, -1 is forever) passes
+    unsigned submitAndWait(unsigned waitFor, int timeout);
+
+    template <typename Handler> size_t reapCompletions(Handler handler) {
+        size_t reaped{0};
+        auto head = *this->m_completionHead;
+        auto tail = __atomic_load_n(this->m_completionTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            //Copied and released before the handler runs, so the handler is free to queue more work
+            auto completion = this->m_completions[head & *this->m_completionMask];
+            head++;
+            __atomic_store_n(this->m_completionHead, head, __ATOMIC_RELEASE);
+            if (completion.user_data != TIMEOUT_USER_DATA) {
+                handler(completion);
+                reaped++;
+            }
+            tail = __atomic_load_n(this->m_completionTail, __ATOMIC_ACQUIRE);
+        }
+        return reaped;
+    }
+
+    void registerBuffers(const iovec *buffers, unsigned count);
+    void registerFiles(const int *fileDescriptors, unsigned count);
+    void updateFile(unsigned index, int fileDescriptor);
+
+    //Reserved for the timeouts submitAndWait() queues itself on kernels without IORING_FEAT_EXT_ARG
+    static const uint64_t TIMEOUT_USER_DATA;
+
+private:
+    int m_ringDescriptor;
+    io_uring_params m_parameters;
+    void *m_submissionRing;
+    size_t m_submissionRingSize;
+    void *m_completionRing;
+    size_t m_completionRingSize;
+    io_uring_sqe *m_submissionEntries;
+    size_t m_submissionEntriesSize;
+    unsigned *m_submissionHead;
+    unsigned *m_submissionTail;
+    unsigned *m_submissionMask;
+    unsigned *m_submissionArray;
+    unsigned *m_completionHead;
+    unsigned *m_completionTail;
+    unsigned *m_completionMask;
+    io_uring_cqe *m_completions;
+    unsigned m_queuedTail;
+    __kernel_timespec m_timeout;
+
+    void unmap();
+    int enter(unsigned toSubmit, unsigned waitFor, unsigned flags, const void *argument, size_t argumentSize);
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_IOURING_HPP
@@ -0,0 +1,72 @@
+#ifndef CPPSERIALPORT_SOCKETOPTIONS_HPP
+#define CPPSERIALPORT_SOCKETOPTIONS_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "DescriptorWaiter.hpp"
+
+namespace CppSerialPort {
+
+enum class ReceiveTimestamping {
+    Disabled,
+    //Kernel receive time on the system clock (SO_TIMESTAMPNS, SO_TIMESTAMP on the BSDs)
+    Software,
+    //Linux only: the network card's receive time (SO_TIMESTAMPING), with the kernel time alongside.
+    //Receive timestamping must already be switched on for the card (SIOCSHWTSTAMP, e.g. with hwstamp_ctl)
+    Hardware
+};
+
+//Typed collection of socket level tuning (setsockopt()) options
+//AbstractSocket applies these right after creating its socket and before connecting,
+//so options like the buffer sizes are in place when the connection is negotiated
+class SocketOptions
+{
+public:
+    SocketOptions();
+
+    //Disables Nagle's algorithm, so small writes go out immediately instead of waiting for an ACK
+    SocketOptions &setNoDelay(bool noDelay);
+    //Linux only: ACK immediately instead of delaying. The kernel clears this on its own,
+    //so TcpSocket sets it again after every receive while it is enabled
+    SocketOptions &setQuickAck(bool quickAck);
+    SocketOptions &setReceiveBufferSize(int bytes);
+    SocketOptions &setSendBufferSize(int bytes);
+    //Linux only: spin on the device queue for up to this long when a read would block
+    SocketOptions &setBusyPoll(std::chrono::microseconds busyPoll);
+    //Linux only: queueing priority (0 - 6 without CAP_NET_ADMIN) of outgoing packets
+    SocketOptions &setPriority(int priority);
+    SocketOptions &setKeepAlive(bool keepAlive);
+    SocketOptions &setKeepAlive(std::chrono::seconds idle, std::chrono::seconds interval, int probeCount);
+    //Lets several sockets bind the same port, for example one UDP receiver per worker thread
+    SocketOptions &setReusePort(bool reusePort);
+    //Has the kernel attach receive timestamps to what is read, see IByteStream::readChunk()
+    SocketOptions &setReceiveTimestamping(ReceiveTimestamping timestamping);
+    //Any other integer valued option, such as SOL_SOCKET/SO_MARK
+    SocketOptions &setOption(int level, int name, int value, const std::string &description);
+
+    bool quickAck() const;
+    ReceiveTimestamping receiveTimestamping() const;
+    bool empty() const;
+
+    SocketOptions &merge(const SocketOptions &other);
+    void apply(DescriptorWaiter::descriptor_t socketDescriptor) const;
+
+    struct Option {
+        int level;
+        int name;
+        int value;
+        std::string description;
+    };
+
+    const std::vector<Option> &options() const;
+
+private:
+    std::vector<Option> m_options;
+
+    const Option *find(int level, int name) const;
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_SOCKETOPTIONS_HPP
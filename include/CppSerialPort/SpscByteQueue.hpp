@@ -0,0 +1,45 @@
+#ifndef CPPSERIALPORT_SPSCBYTEQUEUE_HPP
+#define CPPSERIALPORT_SPSCBYTEQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace CppSerialPort {
+
+//Fixed capacity lock-free byte queue for exactly one producer thread and one consumer thread
+//The producer may receive straight into writeSpan() and publish with commitWrite()
+class SpscByteQueue {
+public:
+    explicit SpscByteQueue(size_t capacity);
+    SpscByteQueue(const SpscByteQueue &) = delete;
+    SpscByteQueue(SpscByteQueue &&) = delete;
+    SpscByteQueue &operator=(const SpscByteQueue &) = delete;
+    SpscByteQueue &operator=(SpscByteQueue &&) = delete;
+    ~SpscByteQueue() = default;
+
+    //Producer side
+    std::pair<char *, size_t> writeSpan();
+    void commitWrite(size_t count);
+    size_t push(const char *bytes, size_t length);
+
+    //Consumer side
+    size_t pop(char *buffer, size_t maximum);
+    void clear();
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+
+private:
+    std::vector<char> m_buffer;
+    size_t m_mask;
+    //Both indexes only ever increase, so (tail - head) is the size even after wrapping around
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_SPSCBYTEQUEUE_HPP
@@ -0,0 +1,93 @@
+#ifndef CPPSERIALPORT_STREAMBRIDGE_HPP
+#define CPPSERIALPORT_STREAMBRIDGE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "IByteStream.hpp"
+
+namespace CppSerialPort {
+
+//Pumps bytes both ways between two open streams (for example a SerialPort and a TcpSocket) until either reaches end of stream
+//Each direction moves data with splice() through a pipe, so it never enters user space, and falls back to a plain
+//read()/write() buffer on its own when the kernel cannot splice that descriptor (ttys cannot be spliced from)
+//The streams are switched to non-blocking for the duration and must not be used by anything else while bridged
+class StreamBridge
+{
+public:
+    enum class Direction {
+        FirstToSecond,
+        SecondToFirst
+    };
+
+    enum class TransferMode {
+        Splice,
+        Buffered
+    };
+
+    struct DirectionStatistics {
+        TransferMode mode;
+        uint64_t bytes;
+        uint64_t transfers;
+        double bytesPerSecond;
+        //From the source becoming readable until those bytes are all written to the destination
+        std::chrono::microseconds lastLatency;
+        std::chrono::microseconds averageLatency;
+        std::chrono::microseconds maximumLatency;
+    };
+
+    StreamBridge(IByteStream &first, IByteStream &second);
+    StreamBridge(const StreamBridge &) = delete;
+    StreamBridge(StreamBridge &&) = delete;
+    StreamBridge &operator=(const StreamBridge &) = delete;
+    StreamBridge &operator=(StreamBridge &&) = delete;
+    ~StreamBridge();
+
+    void setSpliceEnabled(bool enabled);
+    bool spliceEnabled() const;
+    void setChunkSize(size_t chunkSize);
+    size_t chunkSize() const;
+
+    //Blocks until stop() is called or either stream ends, throwing if either stream fails
+    void run();
+    //Runs on a background thread instead, keeping any failure for error()
+    void start();
+    void stop();
+    bool isRunning() const;
+    std::string error() const;
+
+    DirectionStatistics statistics(Direction direction) const;
+
+    static const size_t DEFAULT_CHUNK_SIZE;
+
+private:
+    struct Pump;
+
+    IByteStream &m_first;
+    IByteStream &m_second;
+    bool m_spliceEnabled;
+    size_t m_chunkSize;
+    std::unique_ptr<Pump> m_firstToSecond;
+    std::unique_ptr<Pump> m_secondToFirst;
+    std::atomic<bool> m_running;
+    int m_wakeDescriptor;
+    std::thread m_thread;
+    mutable std::mutex m_statisticsMutex;
+    std::string m_error;
+    std::chrono::steady_clock::time_point m_startedAt;
+    std::chrono::steady_clock::time_point m_stoppedAt;
+
+    void pump();
+    void transferIn(Pump &pump, std::chrono::steady_clock::time_point readyAt);
+    void transferOut(Pump &pump);
+    void fallBackToBuffered(Pump &pump);
+    void closePipe(Pump &pump);
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_STREAMBRIDGE_HPP
@@ -0,0 +1,132 @@
+#ifndef CPPSERIALPORT_STREAMREACTOR_HPP
+#define CPPSERIALPORT_STREAMREACTOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "IByteStream.hpp"
+#include "TcpServer.hpp"
+
+struct io_uring_sqe;
+
+namespace CppSerialPort {
+
+class IoUring;
+
+//Single threaded event loop that waits on many streams with one edge triggered epoll set, or with io_uring
+//Streams added to a reactor must only be read from the thread calling poll() or run()
+//With the io_uring backend every stream keeps a poll linked to a read into a registered buffer through a fixed file,
+//so a ready stream costs no system calls of its own: completions are reaped from shared memory, and the re-armed reads
+//and queued writes all go to the kernel together on the next poll()
+//Bytes read this way bypass the stream's own read buffer, so the stream must not be read directly while it is added
+class StreamReactor
+{
+public:
+    enum class Backend {
+        Automatic,
+        Epoll,
+        IoUring
+    };
+
+    using ReadCallback = std::function<void(IByteStream &stream, const ByteArray &bytes)>;
+    using ErrorCallback = std::function<void(IByteStream &stream, const std::exception &exception)>;
+    using AcceptCallback = std::function<void(TcpServer &server, std::unique_ptr<TcpSocket> socket)>;
+
+    //Automatic picks io_uring when the kernel allows it and falls back to epoll otherwise
+    explicit StreamReactor(Backend backend = Backend::Automatic);
+    StreamReactor(const StreamReactor &) = delete;
+    StreamReactor(StreamReactor &&) = delete;
+    StreamReactor &operator=(const StreamReactor &) = delete;
+    StreamReactor &operator=(StreamReactor &&) = delete;
+    ~StreamReactor();
+
+    void add(IByteStream &stream, const ReadCallback &onRead, const ErrorCallback &onError = nullptr);
+    bool remove(IByteStream &stream);
+    bool contains(const IByteStream &stream) const;
+    //Every connection queued on the server is accepted and handed over each time it becomes readable
+    //Errors from accept (such as running out of file descriptors) are thrown from poll()
+    void addServer(TcpServer &server, const AcceptCallback &onAccept);
+    bool remove(TcpServer &server);
+    size_t size() const;
+    Backend backend() const;
+
+    //Writes without blocking the caller: under io_uring the bytes go out, in order, with the next submission,
+    //under epoll they are written straight away. Write errors are reported to the stream's error callback
+    void queueWrite(IByteStream &stream, const ByteArray &bytes);
+
+    size_t poll(int timeout);
+    void run();
+    void stop();
+    bool isRunning() const;
+
+    static const int constexpr MAXIMUM_EVENTS_PER_POLL{256};
+    static const unsigned constexpr MAXIMUM_URING_STREAMS{512};
+    static const unsigned constexpr URING_QUEUE_DEPTH{2048};
+    static const size_t constexpr URING_READ_SIZE{8192};
+
+private:
+    struct Registration {
+        IByteStream *stream;
+        ReadCallback onRead;
+        ErrorCallback onError;
+        TcpServer *server;
+        AcceptCallback onAccept;
+        int fileDescriptor;
+        //io_uring backend only
+        unsigned slot;
+        uint32_t generation;
+        int pollError;
+        std::deque<ByteArray> pendingWrites;
+        size_t writeOffset;
+        bool writing;
+    };
+
+    Backend m_backend;
+    int m_epollDescriptor;
+    int m_wakeDescriptor;
+    std::atomic<bool> m_running;
+    mutable std::mutex m_registrationMutex;
+    std::unordered_map<int, std::shared_ptr<Registration>> m_registrations;
+    std::unique_ptr<IoUring> m_ring;
+    std::vector<char> m_ringBuffers;
+    bool m_fixedBuffers;
+    std::vector<std::shared_ptr<Registration>> m_slots;
+    std::vector<unsigned> m_slotOperations;
+    std::vector<uint32_t> m_slotGenerations;
+    std::vector<std::shared_ptr<Registration>> m_armQueue;
+    std::vector<std::shared_ptr<Registration>> m_releaseQueue;
+    std::vector<std::shared_ptr<Registration>> m_writeQueue;
+    std::atomic<std::thread::id> m_pollingThread;
+
+    std::shared_ptr<Registration> findRegistration(int fileDescriptor) const;
+    std::shared_ptr<Registration> findRegistration(const IByteStream &stream) const;
+    bool isRegistered(const std::shared_ptr<Registration> &registration) const;
+    void addRegistration(int fileDescriptor, const std::shared_ptr<Registration> &registration, const std::string &name);
+    bool removeRegistration(const std::function<bool(const Registration &)> &matches);
+    void dispatch(int fileDescriptor, uint32_t events);
+    void hangup(const std::shared_ptr<Registration> &registration);
+    void fail(const std::shared_ptr<Registration> &registration, int fileDescriptor, const std::exception &exception);
+    void clearWakeup();
+    void wakeFromOtherThread();
+
+    void setupEpoll();
+    void setupIoUring();
+    io_uring_sqe *nextSubmission(unsigned reserve = 1);
+    void flushRequests();
+    void armRegistration(const std::shared_ptr<Registration> &registration);
+    void releaseRegistration(const std::shared_ptr<Registration> &registration);
+    void submitWrite(const std::shared_ptr<Registration> &registration);
+    void armWakeup();
+    bool complete(uint64_t userData, int32_t result);
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_STREAMREACTOR_HPP
@@ -0,0 +1,78 @@
+#ifndef CPPSERIALPORT_TCPCONNECTOR_HPP
+#define CPPSERIALPORT_TCPCONNECTOR_HPP
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "HostResolver.hpp"
+#include "SocketOptions.hpp"
+#include "TcpSocket.hpp"
+
+namespace CppSerialPort {
+
+//Non-blocking TCP connect that races the resolved addresses (Happy Eyeballs, RFC 8305)
+//Addresses are interleaved by family, and a new attempt starts every attemptDelay (or as soon as one fails),
+//while earlier attempts keep going. The first to complete wins and the rest are closed
+//It never blocks unless run() is called, so an event loop can drive many at once: wait for any of
+//pendingDescriptors() to become writable or for nextWakeup(), then call advance()
+class TcpConnector
+{
+public:
+    enum class State {
+        Connecting,
+        Connected,
+        Failed
+    };
+
+    TcpConnector(const std::vector<ResolvedAddress> &addresses, std::chrono::steady_clock::time_point deadline, const SocketOptions &socketOptions = SocketOptions{}, std::chrono::milliseconds attemptDelay = DEFAULT_ATTEMPT_DELAY);
+    TcpConnector(const TcpConnector &) = delete;
+    TcpConnector(TcpConnector &&) = delete;
+    TcpConnector &operator=(const TcpConnector &) = delete;
+    TcpConnector &operator=(TcpConnector &&) = delete;
+    ~TcpConnector();
+
+    State advance();
+    State run();
+    State state() const;
+    std::string error() const;
+
+    std::vector<socket_t> pendingDescriptors() const;
+    std::chrono::steady_clock::time_point nextWakeup() const;
+
+    //Hands over the connected descriptor (back in blocking mode), after which the connector no longer owns it
+    socket_t takeDescriptor();
+    std::unique_ptr<TcpSocket> takeSocket();
+    const ResolvedAddress &connectedAddress() const;
+
+    static std::vector<ResolvedAddress> interleave(const std::vector<ResolvedAddress> &addresses);
+
+    static const std::chrono::milliseconds DEFAULT_ATTEMPT_DELAY;
+
+private:
+    struct Attempt {
+        socket_t socketDescriptor;
+        size_t addressIndex;
+    };
+
+    std::vector<ResolvedAddress> m_addresses;
+    std::chrono::steady_clock::time_point m_deadline;
+    SocketOptions m_socketOptions;
+    std::chrono::milliseconds m_attemptDelay;
+    std::vector<Attempt> m_attempts;
+    size_t m_nextAddress;
+    std::chrono::steady_clock::time_point m_nextAttemptAt;
+    State m_state;
+    std::string m_error;
+    socket_t m_connectedDescriptor;
+    size_t m_connectedAddress;
+
+    bool startAttempt(size_t addressIndex);
+    void finish(size_t attemptIndex);
+    void fail(const std::string &error);
+    void closeAttempts();
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_TCPCONNECTOR_HPP
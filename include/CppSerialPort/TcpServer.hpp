@@ -0,0 +1,54 @@
+#ifndef CPPSERIALPORT_TCPSERVER_HPP
+#define CPPSERIALPORT_TCPSERVER_HPP
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TcpSocket.hpp"
+
+namespace CppSerialPort {
+
+//Listening TCP socket
+//The listening descriptor is non-blocking, so acceptPending() can drain every queued connection
+//after one readiness notification (for example from StreamReactor::addServer())
+class TcpServer
+{
+public:
+    explicit TcpServer(uint16_t portNumber, const std::string &bindAddress = "");
+    TcpServer(const TcpServer &) = delete;
+    TcpServer(TcpServer &&) = delete;
+    TcpServer &operator=(const TcpServer &) = delete;
+    TcpServer &operator=(TcpServer &&) = delete;
+    ~TcpServer();
+
+    void listen();
+    void close();
+    bool isListening() const;
+
+    std::unique_ptr<TcpSocket> accept(std::chrono::steady_clock::time_point deadline);
+    std::unique_ptr<TcpSocket> tryAccept();
+    std::vector<std::unique_ptr<TcpSocket>> acceptPending();
+
+    void setBacklog(int backlog);
+    int backlog() const;
+    void setReusePort(bool reusePort);
+    bool reusePort() const;
+
+    uint16_t portNumber() const;
+    std::string bindAddress() const;
+    int fileDescriptor() const;
+
+    static const int DEFAULT_BACKLOG;
+
+private:
+    socket_t m_socketDescriptor;
+    uint16_t m_portNumber;
+    std::string m_bindAddress;
+    int m_backlog;
+    bool m_reusePort;
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_TCPSERVER_HPP
@@ -5,16 +5,77 @@
 
 namespace CppSerialPort {
 
+//How an opted-in TcpSocket recovers from a dropped connection
+//The delay before each retry grows by multiplier up to maximumDelay, and is scaled down by a random
+//factor of up to jitter, so many sockets losing the same peer do not all retry at once
+struct ReconnectPolicy {
+    std::chrono::milliseconds initialDelay{100};
+    std::chrono::milliseconds maximumDelay{30000};
+    double multiplier{2.0};
+    double jitter{0.5};
+    //Bytes written while disconnected are kept up to this size and sent once reconnected
+    size_t replayBufferCapacity{1024 * 1024};
+    //0 keeps trying forever
+    size_t maximumAttempts{0};
+};
+
+struct ReconnectStatistics {
+    bool reconnecting;
+    uint64_t attempts;
+    uint64_t reconnects;
+    std::chrono::microseconds lastReconnectLatency;
+    size_t replayBufferSize;
+    uint64_t rejectedBytes;
+    std::string lastError;
+};
+
 class TcpSocket : public AbstractSocket {
 public:
     TcpSocket(const std::string &hostName, uint16_t portNumber);
     TcpSocket(const IPV4Address &ipAddress, uint16_t portNumber);
-    ~TcpSocket() override = default;
+    TcpSocket(socket_t connectedDescriptor, const sockaddr *peerAddress, socklen_t peerAddressLength);
+    ~TcpSocket() override;
+
+    void setNoDelay(bool noDelay);
+    bool noDelay() const;
+    void setQuickAck(bool quickAck);
+
+    //Once enabled, a dropped connection no longer throws SocketDisconnectedException. Instead it is reestablished on a
+    //background thread while reads time out as usual and writes go to the replay buffer (a write that does not fit is
+    //rejected whole and returns 0). Bytes the old connection accepted but the peer never received are lost
+    //SocketDisconnectedException is only thrown again once maximumAttempts is used up
+    void enableReconnect(const ReconnectPolicy &policy = ReconnectPolicy{});
+    void disableReconnect();
+    bool isReconnectEnabled() const;
+    ReconnectStatistics reconnectStatistics() const;
+
+    using AbstractSocket::write;
+    ssize_t write(char c) override;
+    ssize_t write(const char *bytes, size_t byteCount) override;
+    ByteArray readAvailable() override;
+    size_t available() override;
+    void closePort() override;
+
 protected:
     ssize_t doWrite(const char *bytes, size_t byteCount) override;
+    ssize_t doWrite(const ConstBuffer *buffers, size_t count) override;
     ssize_t doRead(char *buffer, size_t bufferMax) override;
     void doConnect() override;
+    void connectToAny(const std::vector<ResolvedAddress> &addresses, std::chrono::steady_clock::time_point deadline) override;
     addrinfo getAddressInfoHints() override;
+    size_t readFromDevice(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) override;
+    ssize_t writeBuffers(const ConstBuffer *buffers, size_t count) override;
+
+private:
+    struct Reconnector;
+
+    std::unique_ptr<Reconnector> m_reconnector;
+
+    void startReconnect();
+    void runReconnect();
+    bool adoptReconnected();
+    bool waitForReconnect(std::chrono::steady_clock::time_point deadline);
+    void stopReconnect();
 };
 
 } //namespace CppSerialPort
@@ -0,0 +1,32 @@
+#ifndef CPPSERIALPORT_TERMIOS2_HPP
+#define CPPSERIALPORT_TERMIOS2_HPP
+
+#include <cstdint>
+
+namespace CppSerialPort {
+
+//Linux only: termios2 (TCGETS2/TCSETS2) carries the speed as a plain number, so with BOTHER a driver can be
+//set to any rate it supports instead of only the B* constants. The kernel's <asm/termbits.h> cannot be included
+//next to <termios.h>, so these calls live in their own translation unit and take the settings as plain fields
+namespace Termios2 {
+
+    //Same layout and control character indices as the kernel's struct termios2 without the speeds
+    struct Attributes {
+        uint32_t inputFlags;
+        uint32_t outputFlags;
+        uint32_t controlFlags;
+        uint32_t localFlags;
+        unsigned char lineDiscipline;
+        unsigned char controlCharacters[19];
+    };
+
+    //Applies everything with a single TCSETS2, both directions at baudRate
+    void setAttributes(int fileDescriptor, const Attributes &attributes, uint32_t baudRate);
+    //The output rate as the driver stored it, which drivers round to what they can actually generate
+    uint32_t outputBaudRate(int fileDescriptor);
+
+} //namespace Termios2
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_TERMIOS2_HPP
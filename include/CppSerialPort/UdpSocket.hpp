@@ -3,18 +3,103 @@
 
 #include "AbstractSocket.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace CppSerialPort {
 
+//One received datagram, pointing into the slab of the DatagramBatch it was received into
+struct Datagram {
+    const char *data;
+    size_t length;
+    const sockaddr_storage *source;
+    socklen_t sourceLength;
+    bool truncated;
+    //Zero unless receive timestamps are enabled on the socket
+    ReceiveTimestamp timestamp;
+};
+
+//Preallocated storage for receiving many datagrams with one system call
+//The Datagram views stay valid until the batch is received into again
+class DatagramBatch {
+public:
+    explicit DatagramBatch(size_t capacity = DEFAULT_CAPACITY, size_t maximumDatagramSize = DEFAULT_MAXIMUM_DATAGRAM_SIZE);
+    DatagramBatch(const DatagramBatch &) = delete;
+    DatagramBatch(DatagramBatch &&) noexcept = default;
+    DatagramBatch &operator=(const DatagramBatch &) = delete;
+    DatagramBatch &operator=(DatagramBatch &&) noexcept = default;
+    ~DatagramBatch() = default;
+
+    const Datagram &operator[](size_t index) const;
+    const Datagram &at(size_t index) const;
+    std::vector<Datagram>::const_iterator begin() const;
+    std::vector<Datagram>::const_iterator end() const;
+    size_t size() const;
+    bool empty() const;
+    size_t capacity() const;
+    size_t maximumDatagramSize() const;
+    void clear();
+
+    static const size_t DEFAULT_CAPACITY;
+    static const size_t DEFAULT_MAXIMUM_DATAGRAM_SIZE;
+
+private:
+    friend class UdpSocket;
+
+    size_t m_maximumDatagramSize;
+    std::vector<char> m_slab;
+    std::vector<sockaddr_storage> m_sources;
+    std::vector<Datagram> m_datagrams;
+#if defined(__linux__)
+    std::vector<iovec> m_ioVectors;
+    std::vector<mmsghdr> m_messageHeaders;
+    std::vector<char> m_control;
+#endif //defined(__linux__)
+};
+
 class UdpSocket : public AbstractSocket {
 public:
     UdpSocket(const std::string &hostName, uint16_t portNumber);
     UdpSocket(const IPV4Address &ipAddress, uint16_t portNumber);
     ~UdpSocket() override = default;
+
+    size_t receiveBatch(DatagramBatch &batch);
+    size_t receiveBatch(DatagramBatch &batch, std::chrono::steady_clock::time_point deadline);
+    size_t sendBatch(const ConstBuffer *datagrams, size_t count);
+    size_t sendBatch(const std::vector<ConstBuffer> &datagrams);
+
+    //Multicast groups are joined on a bound socket (bindSocket() to the group's port first)
+    //An empty interface name lets the kernel pick the interface from the routing table
+    void joinGroup(const std::string &groupAddress, const std::string &interfaceName = "");
+    void leaveGroup(const std::string &groupAddress, const std::string &interfaceName = "");
+    void setMulticastInterface(const std::string &interfaceName);
+    void setMulticastTtl(int ttl);
+    int multicastTtl() const;
+    void setMulticastLoopback(bool loopback);
+    bool multicastLoopback() const;
+    static bool isMulticastAddress(const std::string &address);
+
+    //Opens count sockets bound to the same port with SO_REUSEPORT, one per receiving thread
+    //The kernel spreads unicast datagrams across the group by flow hash. Multicast datagrams
+    //are delivered to every member instead, so to spread multicast load give each member its own group
+    static std::vector<std::unique_ptr<UdpSocket>> openReusePortGroup(const std::string &hostName, uint16_t portNumber, size_t count, const std::string &interfaceName = "");
+
 protected:
     ssize_t doWrite(const char *bytes, size_t byteCount) override;
+    ssize_t doWrite(const ConstBuffer *buffers, size_t count) override;
     ssize_t doRead(char *buffer, size_t bufferMax) override;
     void doConnect() override;
     addrinfo getAddressInfoHints() override;
+
+private:
+    void changeMembership(const std::string &groupAddress, const std::string &interfaceName, bool join);
+    int ipProtocolLevel() const;
+    static unsigned int interfaceIndex(const std::string &interfaceName);
+
+#if defined(__linux__)
+    std::vector<iovec> m_sendVectors;
+    std::vector<mmsghdr> m_sendHeaders;
+#endif //defined(__linux__)
 };
 
 } //namespace CppSerialPort
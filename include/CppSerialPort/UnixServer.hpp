@@ -0,0 +1,50 @@
+#ifndef CPPSERIALPORT_UNIXSERVER_HPP
+#define CPPSERIALPORT_UNIXSERVER_HPP
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "UnixSocket.hpp"
+
+namespace CppSerialPort {
+
+//Listening local (AF_UNIX) socket, the counterpart of TcpServer
+//A stale socket file left at the path by an earlier run is replaced, and the file is removed again on close()
+class UnixServer
+{
+public:
+    explicit UnixServer(const std::string &path, UnixSocketType type = UnixSocketType::Stream);
+    UnixServer(const UnixServer &) = delete;
+    UnixServer(UnixServer &&) = delete;
+    UnixServer &operator=(const UnixServer &) = delete;
+    UnixServer &operator=(UnixServer &&) = delete;
+    ~UnixServer();
+
+    void listen();
+    void close();
+    bool isListening() const;
+
+    std::unique_ptr<UnixSocket> accept(std::chrono::steady_clock::time_point deadline);
+    std::unique_ptr<UnixSocket> tryAccept();
+    std::vector<std::unique_ptr<UnixSocket>> acceptPending();
+
+    void setBacklog(int backlog);
+    int backlog() const;
+
+    std::string path() const;
+    UnixSocketType type() const;
+    int fileDescriptor() const;
+
+    static const int DEFAULT_BACKLOG;
+
+private:
+    socket_t m_socketDescriptor;
+    std::string m_path;
+    UnixSocketType m_type;
+    int m_backlog;
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_UNIXSERVER_HPP
@@ -0,0 +1,61 @@
+#ifndef CPPSERIALPORT_UNIXSOCKET_HPP
+#define CPPSERIALPORT_UNIXSOCKET_HPP
+
+#include "AbstractSocket.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace CppSerialPort {
+
+enum class UnixSocketType {
+    Stream,
+    SeqPacket
+};
+
+//Local (AF_UNIX) socket, for consumers on the same machine that have no use for the TCP stack
+//A path starting with '@' names a socket in the Linux abstract namespace, which has no file and vanishes with its last user
+//SeqPacket keeps message boundaries on the wire, but reads through IByteStream see a byte stream: use
+//readWithDescriptors() with a buffer large enough for a whole message to read one message at a time
+class UnixSocket : public AbstractSocket {
+public:
+    explicit UnixSocket(const std::string &path, UnixSocketType type = UnixSocketType::Stream);
+    //Adopts a descriptor that is already connected (from UnixServer, or one end of socketpair())
+    UnixSocket(socket_t connectedDescriptor, UnixSocketType type, const std::string &path);
+    ~UnixSocket() override = default;
+
+    static std::pair<std::unique_ptr<UnixSocket>, std::unique_ptr<UnixSocket>> createPair(UnixSocketType type = UnixSocketType::Stream);
+    static ResolvedAddress resolvePath(const std::string &path, UnixSocketType type);
+
+    std::string portName() const override;
+    std::string path() const;
+    bool isAbstract() const;
+    UnixSocketType type() const;
+
+    //Sends open descriptors along with the bytes (SCM_RIGHTS), and the receiving process gets its own copies of them
+    //At least one byte has to go with them
+    ssize_t writeWithDescriptors(const char *bytes, size_t byteCount, const std::vector<int> &descriptors);
+    //Reads like read(), also handing over any descriptors that arrived with the bytes, which the caller then owns
+    size_t readWithDescriptors(char *buffer, size_t maximum, std::vector<int> *descriptors, std::chrono::steady_clock::time_point deadline);
+
+    static const size_t MAXIMUM_DESCRIPTORS_PER_MESSAGE;
+
+protected:
+    ssize_t doWrite(const char *bytes, size_t byteCount) override;
+    ssize_t doWrite(const ConstBuffer *buffers, size_t count) override;
+    ssize_t doRead(char *buffer, size_t bufferMax) override;
+    void doConnect() override;
+    addrinfo getAddressInfoHints() override;
+    std::shared_ptr<const std::vector<ResolvedAddress>> resolveAddresses(const addrinfo &hints) override;
+
+private:
+    UnixSocket(socket_t connectedDescriptor, UnixSocketType type, const std::string &path, const ResolvedAddress &address);
+
+    std::string m_path;
+    UnixSocketType m_type;
+};
+
+} //namespace CppSerialPort
+
+#endif //CPPSERIALPORT_UNIXSOCKET_HPP
@@ -1,4 +1,6 @@
 #include <iostream>
+#include <iomanip>
+#include <sstream>
 #include <algorithm>
 #include <string>
 #include <vector>
@@ -9,12 +11,15 @@
 std::string nativeOptionsPrefix{"/dev/ttyS"};
 std::vector<std::string> optionPrefixes{"--", "-"};
 std::vector<std::string> skipNativeOptions{"s", "skip-native"};
+std::vector<std::string> verboseOptions{"v", "verbose"};
 
 bool skipNativePorts{false};
+bool verbose{false};
 bool unknownOption{false};
 
 int findLastNonNumeric(const std::string &str);
 int getNumericPortNumber(const std::string &str);
+std::string describePort(const std::string &name, const std::map<std::string, CppSerialPort::SerialPortInfo> &portInfo);
 
 int main(int argc, char *argv[]) {
     for (int i = 1; i < argc; i++) {
@@ -40,6 +45,13 @@ int main(int argc, char *argv[]) {
                 break;
             }
         }
+        for (const auto &it : verboseOptions) {
+            if (temp == it) {
+                verbose = true;
+                unknownOption = false;
+                break;
+            }
+        }
         if (unknownOption) {
             std::cout << "Unknown option \"" << copy << "\"" << std::endl;
         }
@@ -48,7 +60,10 @@ int main(int argc, char *argv[]) {
     std::vector<std::string> serialPortNames{};
     std::set<std::string> prefixes{};
     std::set<std::string> unknownNames{};
-    for (const auto &it : CppSerialPort::SerialPort::availableSerialPorts()) {
+    std::map<std::string, CppSerialPort::SerialPortInfo> portInfo{};
+    for (const auto &info : CppSerialPort::SerialPort::availableSerialPortInfo()) {
+        const auto &it = info.name;
+        portInfo.emplace(it, info);
         auto index = findLastNonNumeric(it);
         if (index == -1) {
             unknownNames.emplace(it);
@@ -72,15 +87,38 @@ int main(int argc, char *argv[]) {
             }
         }
         for (const auto &innerIt: values) {
-            std::cout << innerIt.second << std::endl;
+            std::cout << describePort(innerIt.second, portInfo) << std::endl;
         }
     }
     for (const auto &it : unknownNames) {
-        std::cout << it << std::endl;
+        std::cout << describePort(it, portInfo) << std::endl;
     }
     return 0;
 }
 
+std::string describePort(const std::string &name, const std::map<std::string, CppSerialPort::SerialPortInfo> &portInfo) {
+    auto found = portInfo.find(name);
+    if ( (!verbose) || (found == portInfo.end()) ) {
+        return name;
+    }
+    const auto &info = found->second;
+    std::stringstream description{};
+    description << name;
+    if (!info.driver.empty()) {
+        description << " driver=" << info.driver;
+    }
+    if ( (info.vendorId != 0) || (info.productId != 0) ) {
+        description << " usb=" << std::hex << std::setfill('0') << std::setw(4) << info.vendorId << ':' << std::setw(4) << info.productId << std::dec;
+    }
+    if (!info.product.empty()) {
+        description << " product=\"" << info.product << '"';
+    }
+    if (!info.serialNumber.empty()) {
+        description << " serial=" << info.serialNumber;
+    }
+    return description.str();
+}
+
 int findLastNonNumeric(const std::string &str) {
     int index{-1};
     for (size_t i = 0; i < str.length(); i++) {
@@ -1,5 +1,7 @@
 #include <CppSerialPort/AbstractSocket.hpp>
 #include <CppSerialPort/ErrorInformation.hpp>
+#include <CppSerialPort/DescriptorWaiter.hpp>
+#include <CppSerialPort/HostResolver.hpp>
 
 #if defined(_WIN32)
 #    include <ws2tcpip.h>
@@ -10,10 +12,16 @@
 #    include <unistd.h>
 #    include <fcntl.h>
 #    include <sys/ioctl.h>
+#    include <sys/uio.h>
 #    define INVALID_SOCKET (-1)
      using sockopt_t = int;
 
 #endif //defined(_WIN32)
+
+#if defined(__linux__)
+#    include <linux/errqueue.h>
+#endif //defined(__linux__)
+#include <algorithm>
 #include <cstring>
 #include <climits>
 #include <iostream>
@@ -22,21 +30,34 @@
 using NetworkErrorInformation::getLastError;
 using NetworkErrorInformation::getErrorString;
 
+#if defined(__linux__)
+namespace {
+    std::chrono::nanoseconds toNanoseconds(const timespec &time) {
+        return std::chrono::seconds{time.tv_sec} + std::chrono::nanoseconds{time.tv_nsec};
+    }
+}
+#endif //defined(__linux__)
+
 namespace CppSerialPort {
 
 const uint16_t AbstractSocket::MINIMUM_PORT_NUMBER{1024};
 const uint16_t AbstractSocket::MAXIMUM_PORT_NUMBER{std::numeric_limits<uint16_t>::max()};
-
-#define ABSTRACT_SOCKET_BUFFER_MAX 8192
+const std::chrono::microseconds AbstractSocket::DEFAULT_CONNECT_TIMEOUT{std::chrono::seconds{3}};
+#if !defined(_WIN32)
+//Room for an SCM_TIMESTAMPING (three timespecs) and an SCM_TIMESTAMPNS message
+const size_t AbstractSocket::RECEIVE_TIMESTAMP_CONTROL_SIZE{128};
+#endif //!defined(_WIN32)
 
 AbstractSocket::AbstractSocket(const std::string &hostName, uint16_t portNumber) :
     IByteStream{},
     m_socketDescriptor{INVALID_SOCKET},
     m_addressInfo{},
+    m_peerAddress{},
     m_hostName{hostName},
     m_portNumber{portNumber},
-    m_readBuffer{""},
-    m_isBound{false}
+    m_isBound{false},
+    m_socketOptions{},
+    m_connectTimeout{DEFAULT_CONNECT_TIMEOUT}
 {
 #if defined(_WIN32)
 #   if defined(_WIN64)
@@ -59,6 +80,49 @@ AbstractSocket::AbstractSocket(const std::string &hostName, uint16_t portNumber)
     IByteStream::setWriteTimeout(DEFAULT_WRITE_TIMEOUT);
 }
 
+AbstractSocket::AbstractSocket(socket_t socketDescriptor, const sockaddr *peerAddress, socklen_t peerAddressLength) :
+    IByteStream{},
+    m_socketDescriptor{socketDescriptor},
+    m_addressInfo{},
+    m_peerAddress{},
+    m_hostName{""},
+    m_portNumber{0},
+    m_isBound{false},
+    m_socketOptions{},
+    m_connectTimeout{DEFAULT_CONNECT_TIMEOUT}
+{
+    //Adopts a descriptor that is already connected (for example, one returned by accept())
+    memcpy(&this->m_peerAddress, peerAddress, std::min<size_t>(peerAddressLength, sizeof(this->m_peerAddress)));
+    this->m_addressInfo.ai_family = peerAddress->sa_family;
+    this->m_addressInfo.ai_addr = reinterpret_cast<sockaddr *>(&this->m_peerAddress);
+    this->m_addressInfo.ai_addrlen = peerAddressLength;
+    char hostName[NI_MAXHOST];
+    char serviceName[NI_MAXSERV];
+    //Only internet addresses have a numeric host and port to show (a local socket has a path instead)
+    auto isInternetAddress = ( (peerAddress->sa_family == AF_INET) || (peerAddress->sa_family == AF_INET6) );
+    if ( (isInternetAddress) && (getnameinfo(peerAddress, peerAddressLength, hostName, sizeof(hostName), serviceName, sizeof(serviceName), NI_NUMERICHOST | NI_NUMERICSERV) == 0) ) {
+        this->m_hostName = hostName;
+        this->m_portNumber = static_cast<uint16_t>(std::stoul(serviceName));
+    }
+    this->setReadTimeout(this->readTimeoutDuration());
+    this->setWriteTimeout(this->writeTimeoutDuration());
+}
+
+AbstractSocket::AbstractSocket(const std::string &localName) :
+    IByteStream{},
+    m_socketDescriptor{INVALID_SOCKET},
+    m_addressInfo{},
+    m_peerAddress{},
+    m_hostName{localName},
+    m_portNumber{0},
+    m_isBound{false},
+    m_socketOptions{},
+    m_connectTimeout{DEFAULT_CONNECT_TIMEOUT}
+{
+    IByteStream::setReadTimeout(DEFAULT_READ_TIMEOUT);
+    IByteStream::setWriteTimeout(DEFAULT_WRITE_TIMEOUT);
+}
+
 AbstractSocket::AbstractSocket(const IPV4Address &ipAddress, uint16_t portNumber) :
     AbstractSocket{ipAddress.toString(), portNumber}
 {
@@ -107,6 +171,14 @@ std::string AbstractSocket::portName() const {
     return '[' + this->m_hostName + ':' + toStdString(this->m_portNumber) + ']';
 }
 
+int AbstractSocket::fileDescriptor() const {
+#if defined(_WIN32)
+    return -1;
+#else
+    return this->m_socketDescriptor;
+#endif //defined(_WIN32)
+}
+
 bool AbstractSocket::isOpen() const {
     return this->isConnected();
 }
@@ -122,7 +194,7 @@ void AbstractSocket::closePort() {
 }
 
 void AbstractSocket::flushRx() {
-    this->m_readBuffer.clear();
+    this->readBuffer().clear();
 }
 
 void AbstractSocket::flushTx() {
@@ -130,17 +202,13 @@ void AbstractSocket::flushTx() {
 }
 
 size_t AbstractSocket::available() {
-    return this->m_readBuffer.size() + this->checkAvailable();
+    return this->readBuffer().size() + this->checkAvailable();
 }
 
 size_t AbstractSocket::rawRead(char *buffer, size_t max) {
-    size_t returnSize{0};
-    while (!this->m_readBuffer.empty()) {
-        buffer[returnSize++] = this->m_readBuffer[0];
-        this->m_readBuffer.popFront();
-        if (returnSize >= max) {
-            return returnSize;
-        }
+    size_t returnSize{this->readBuffer().read(buffer, max)};
+    if (returnSize >= max) {
+        return returnSize;
     }
     auto remainingMax = max - returnSize;
     auto result = this->doRead( (buffer + returnSize), remainingMax);
@@ -160,69 +228,51 @@ size_t AbstractSocket::rawRead(char *buffer, size_t max) {
     }
 }
 
-char AbstractSocket::read(bool *readTimeout) {
-    if (!this->m_readBuffer.empty()) {
-        char returnValue{ this->m_readBuffer[0] };
-        this->m_readBuffer.popFront();
-        if (readTimeout) {
-            *readTimeout = false;
-        }
-        return returnValue;
+ByteArray AbstractSocket::readAvailable() {
+    if (this->isChunkTimestamping()) {
+        return IByteStream::readAvailable();
     }
+    auto pendingBytes = static_cast<size_t>(this->isConnected() ? this->checkAvailable() : 0);
+    std::vector<char> returnBytes(this->readBuffer().size() + pendingBytes);
+    auto returnSize = this->readBuffer().read(returnBytes.data(), returnBytes.size());
+    if (pendingBytes > 0) {
+        returnSize += this->readFromDevice(returnBytes.data() + returnSize, pendingBytes, std::chrono::steady_clock::now());
+    }
+    returnBytes.resize(returnSize);
+    ByteArray returnArray{};
+    returnArray = std::move(returnBytes);
+    return returnArray;
+}
+
+size_t AbstractSocket::readFromDevice(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) {
     if (this->isDisconnected()) {
         this->closePort();
         throw SocketDisconnectedException{this->portName(), "CppSerialPort::AbstractSocket::read(): The server hung up unexpectedly"};
     }
 
-    //Use select() to wait for data to arrive
-    //At socket, then read and return
-    fd_set read_fds{0, 0, 0};
-    fd_set write_fds{0, 0, 0};
-    fd_set except_fds{0, 0, 0};
-    FD_ZERO(&read_fds);
-    FD_ZERO(&write_fds);
-    FD_ZERO(&except_fds);
-    FD_SET(this->m_socketDescriptor, &read_fds);
-
-    struct timeval timeout{0, 0};
-    timeout.tv_sec = 0;
-    timeout.tv_usec = (this->readTimeout() * 1000);
-    static char readBuffer[ABSTRACT_SOCKET_BUFFER_MAX];
-    memset(readBuffer, '\0', ABSTRACT_SOCKET_BUFFER_MAX);
-
-    if (select(static_cast<int>(this->socketDescriptor() + 1), &read_fds, &write_fds, &except_fds, &timeout) == 1) {
-        auto receiveResult = this->doRead(readBuffer, ABSTRACT_SOCKET_BUFFER_MAX - 1);
+    //Wait for data to arrive at the socket until the deadline, then read and return
+    if (this->waitForReadable(deadline)) {
+        auto receiveResult = this->doRead(buffer, maximum);
         if (receiveResult == -1) {
             auto errorCode = getLastError();
             if (errorCode != EAGAIN) {
                 this->closePort();
                 throw SocketDisconnectedException{this->portName(), "CppSerialPort::AbstractSocket::read(): The server hung up unexpectedly"};
             }
-            if (readTimeout) {
-                *readTimeout = true;
-            }
             return 0;
         } else if (receiveResult == 0) {
             this->closePort();
             throw SocketDisconnectedException{this->portName(), "CppSerialPort::AbstractSocket::read(): The server hung up unexpectedly"};
-        } else {
-            for (int i = 0; i < receiveResult; i++) {
-                this->m_readBuffer.append(readBuffer[i]);
-            }
-            char returnValue{this->m_readBuffer[0]};
-            this->m_readBuffer.popFront();
-            if (readTimeout) {
-                *readTimeout = false;
-            }
-            return returnValue;
         }
-    }
-    if (readTimeout) {
-        *readTimeout = true;
+        return static_cast<size_t>(receiveResult);
     }
     return 0;
 }
 
+bool AbstractSocket::waitForReadable(std::chrono::steady_clock::time_point deadline) {
+    return DescriptorWaiter::waitForReadable(this->m_socketDescriptor, deadline);
+}
+
 ssize_t AbstractSocket::checkAvailable() {
 #if defined(_WIN32)
     unsigned long bytesAvailable{0};
@@ -248,7 +298,7 @@ ssize_t AbstractSocket::write(const char *bytes, size_t byteCount) {
     }
     unsigned sentBytes{0};
     //Make sure all bytes are sent
-    auto startTime = IByteStream::getEpoch();
+    auto deadline = deadlineAfter(this->writeTimeoutDuration());
     while (sentBytes < byteCount)  {
         auto sendResult = this->doWrite(bytes + sentBytes, byteCount - sentBytes);
         if (sendResult == -1) {
@@ -260,7 +310,47 @@ ssize_t AbstractSocket::write(const char *bytes, size_t byteCount) {
             throw std::runtime_error("CppSerialPort::AbstractSocket::write(const char *bytes, size_t): send(int, const void *, int, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
         }
         sentBytes += sendResult;
-        if ( (getEpoch() - startTime) >= static_cast<unsigned int>(this->writeTimeout()) ) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+    return sentBytes;
+}
+
+ssize_t AbstractSocket::writeBuffers(const ConstBuffer *buffers, size_t count) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::AbstractSocket::writeBuffers(const ConstBuffer *, size_t): Cannot write on closed socket (call connect first)");
+    }
+    std::vector<ConstBuffer> remaining{buffers, buffers + count};
+    size_t byteCount{0};
+    for (const auto &it : remaining) {
+        byteCount += it.length;
+    }
+    size_t sentBytes{0};
+    size_t firstBuffer{0};
+    //Make sure all bytes are sent, resuming a short send part way through the buffer it stopped in
+    auto deadline = deadlineAfter(this->writeTimeoutDuration());
+    while (sentBytes < byteCount)  {
+        auto sendResult = this->doWrite(remaining.data() + firstBuffer, remaining.size() - firstBuffer);
+        if (sendResult == -1) {
+            auto errorCode = getLastError();
+            if ( (errorCode == ENOTCONN) || (errorCode == EPIPE) || (errorCode == ECONNRESET) ) {
+                this->closePort();
+                throw SocketDisconnectedException{this->portName(), "CppSerialPort::AbstractSocket::write(): The server hung up unexpectedly"};
+            }
+            throw std::runtime_error("CppSerialPort::AbstractSocket::writeBuffers(const ConstBuffer *, size_t): sendmsg(int, const msghdr *, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+        sentBytes += sendResult;
+        auto advance = static_cast<size_t>(sendResult);
+        while ( (firstBuffer < remaining.size()) && (advance >= remaining[firstBuffer].length) ) {
+            advance -= remaining[firstBuffer].length;
+            firstBuffer++;
+        }
+        if (advance > 0) {
+            remaining[firstBuffer].data += advance;
+            remaining[firstBuffer].length -= advance;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
             break;
         }
     }
@@ -268,9 +358,13 @@ ssize_t AbstractSocket::write(const char *bytes, size_t byteCount) {
 }
 
 timeval AbstractSocket::toTimeVal(uint32_t totalTimeout) {
+    return toTimeVal(std::chrono::milliseconds{totalTimeout});
+}
+
+timeval AbstractSocket::toTimeVal(std::chrono::microseconds totalTimeout) {
     timeval tv{0, 0};
-    tv.tv_sec = static_cast<long>(totalTimeout / 1000);
-    tv.tv_usec = static_cast<long>((totalTimeout % 1000) * 1000);
+    tv.tv_sec = static_cast<long>(totalTimeout.count() / 1000000);
+    tv.tv_usec = static_cast<long>(totalTimeout.count() % 1000000);
     return tv;
 }
 
@@ -308,19 +402,37 @@ void AbstractSocket::bindSocket(uint16_t portToBind) {
     if (this->isSocketBound()) {
         throw std::runtime_error("CppSerialPort::AbstractSocket::bindSocket(): Cannot bind socket when already bound (call unbindSocket() first)");
     }
-
-    //Create new addressInfo that will bind to specified port
-    auto boundAddressInfo = this->m_addressInfo;
-    reinterpret_cast<sockaddr_in *>(boundAddressInfo.ai_addr)->sin_port = portToBind;
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::AbstractSocket::bindSocket(): Cannot bind closed socket (call connect() first)");
+    }
+
+    //Bind to the wildcard address of the socket's own family, so the port takes traffic sent to any local address
+    sockaddr_storage boundAddress{};
+    memset(&boundAddress, 0, sizeof(boundAddress));
+    socklen_t boundAddressLength{0};
+    if (this->m_addressInfo.ai_family == AF_INET6) {
+        auto boundAddress6 = reinterpret_cast<sockaddr_in6 *>(&boundAddress);
+        boundAddress6->sin6_family = AF_INET6;
+        boundAddress6->sin6_addr = in6addr_any;
+        boundAddress6->sin6_port = htons(portToBind);
+        boundAddressLength = sizeof(sockaddr_in6);
+    } else {
+        auto boundAddress4 = reinterpret_cast<sockaddr_in *>(&boundAddress);
+        boundAddress4->sin_family = AF_INET;
+        boundAddress4->sin_addr.s_addr = htonl(INADDR_ANY);
+        boundAddress4->sin_port = htons(portToBind);
+        boundAddressLength = sizeof(sockaddr_in);
+    }
 
     //For a client, bind is only important is we want to choose the local port to bindSocket to
     //If a socket is not bound before connect(), the kernel will choose a random one
-    //However, for a server, bindSocket MUST be called before calling listen()
-    auto bindResult = bind(this->m_socketDescriptor, boundAddressInfo.ai_addr, static_cast<int>(boundAddressInfo.ai_addrlen));
+    //However, for a server (or a UDP receiver), bindSocket MUST be called before calling listen() or receiving
+    auto bindResult = bind(this->m_socketDescriptor, reinterpret_cast<sockaddr *>(&boundAddress), boundAddressLength);
     if (bindResult != 0) {
         auto errorCode = getLastError();
         throw std::runtime_error("CppSerialPort::AbstractSocket::bindSocket(): bind(int, int, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
     }
+    this->m_isBound = true;
 }
 
 bool AbstractSocket::isBroadcasting() const {
@@ -350,94 +462,215 @@ void AbstractSocket::setBroadcast(bool broadcast) {
     }
 }
 
+void AbstractSocket::setSocketOptions(const SocketOptions &options) {
+    if (this->isConnected()) {
+        this->applySocketOptions(options);
+    }
+    this->m_socketOptions.merge(options);
+    this->setChunkTimestamping(this->m_socketOptions.receiveTimestamping() != ReceiveTimestamping::Disabled);
+}
+
+const SocketOptions &AbstractSocket::socketOptions() const {
+    return this->m_socketOptions;
+}
+
+int AbstractSocket::socketOption(int level, int name) const {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::AbstractSocket::socketOption(int, int): Cannot read options of closed socket (call connect() first)");
+    }
+    int value{0};
+    socklen_t valueLength{sizeof(value)};
+    if (getsockopt(this->m_socketDescriptor, level, name, reinterpret_cast<sockopt_t *>(&value), &valueLength) != 0) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::AbstractSocket::socketOption(int, int): getsockopt(int, int, int, void *, socklen_t *): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    return value;
+}
+
+void AbstractSocket::setReceiveTimestamping(ReceiveTimestamping timestamping) {
+    this->setSocketOptions(SocketOptions{}.setReceiveTimestamping(timestamping));
+}
+
+ReceiveTimestamping AbstractSocket::receiveTimestamping() const {
+    return this->m_socketOptions.receiveTimestamping();
+}
+
+#if !defined(_WIN32)
+ssize_t AbstractSocket::receiveTimestamped(char *buffer, size_t bufferMax) {
+    union {
+        cmsghdr alignment;
+        char bytes[RECEIVE_TIMESTAMP_CONTROL_SIZE];
+    } control;
+    iovec ioVector{buffer, bufferMax};
+    msghdr message{};
+    message.msg_iov = &ioVector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.bytes;
+    message.msg_controllen = sizeof(control.bytes);
+    auto receiveResult = recvmsg(this->m_socketDescriptor, &message, 0);
+    if (receiveResult > 0) {
+        auto receiveTimestamp = receiveTimestampFrom(message);
+        receiveTimestamp.steady = std::chrono::steady_clock::now();
+        this->setLastReceiveTimestamp(receiveTimestamp);
+    }
+    return receiveResult;
+}
+
+ReceiveTimestamp AbstractSocket::receiveTimestampFrom(const msghdr &message) {
+    ReceiveTimestamp returnTimestamp{};
+    for (auto controlMessage = CMSG_FIRSTHDR(&message); controlMessage != nullptr; controlMessage = CMSG_NXTHDR(const_cast<msghdr *>(&message), controlMessage)) {
+        if (controlMessage->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+#if defined(__linux__)
+        if (controlMessage->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec systemTime{};
+            memcpy(&systemTime, CMSG_DATA(controlMessage), sizeof(systemTime));
+            returnTimestamp.system = toNanoseconds(systemTime);
+        } else if (controlMessage->cmsg_type == SCM_TIMESTAMPING) {
+            //ts[0] is the kernel's time, ts[2] the card's raw time. ts[1] is no longer used
+            scm_timestamping timestamps{};
+            memcpy(&timestamps, CMSG_DATA(controlMessage), sizeof(timestamps));
+            returnTimestamp.system = toNanoseconds(timestamps.ts[0]);
+            returnTimestamp.hardware = toNanoseconds(timestamps.ts[2]);
+        }
+#elif defined(SCM_TIMESTAMP)
+        if (controlMessage->cmsg_type == SCM_TIMESTAMP) {
+            timeval systemTime{};
+            memcpy(&systemTime, CMSG_DATA(controlMessage), sizeof(systemTime));
+            returnTimestamp.system = std::chrono::seconds{systemTime.tv_sec} + std::chrono::microseconds{systemTime.tv_usec};
+        }
+#endif //defined(__linux__)
+    }
+    return returnTimestamp;
+}
+#endif //!defined(_WIN32)
+
+void AbstractSocket::applySocketOptions(const SocketOptions &options) {
+    options.apply(this->m_socketDescriptor);
+}
+
 bool AbstractSocket::isSocketBound() const {
     return this->m_isBound;
 }
 
 void AbstractSocket::connect() {
+    this->connect(deadlineAfter(this->m_connectTimeout));
+}
+
+void AbstractSocket::connect(std::chrono::steady_clock::time_point deadline) {
     if (this->isConnected()) {
-        throw std::runtime_error("CppSerialPort::AbstractSocket::connect(): Cannot connect to new host when already connected (call disconnect() first)");
+        throw std::runtime_error("CppSerialPort::AbstractSocket::connect(std::chrono::steady_clock::time_point): Cannot connect to new host when already connected (call disconnect() first)");
     }
 
-    //Get address info from inheriting class (UDP, TCP, raw socket, etc)
-    addrinfo *addressInfo{nullptr};
     //Get address info from inheriting class (UDP, TCP, raw socket, etc)
     auto hints = this->getAddressInfoHints();
-    auto returnStatus = getaddrinfo(
-            this->hostName().c_str(), //IP Address or hostname
-            toStdString(this->portNumber()).c_str(), //Service (HTTP, port, etc)
-            &hints, //Use the hints specified above
-            &addressInfo //Pointer to linked list to be filled in by getaddrinfo
-    );
+    auto addresses = this->resolveAddresses(hints);
+    this->connectToAny(*addresses, deadline);
 
-    if (returnStatus != 0) {
-        freeaddrinfo(addressInfo);
-        throw std::runtime_error("CppSerialPort::AbstractSocket::connect(): getaddrinfo(const char *, const char *, constr addrinfo *, addrinfo **): error code " + toStdString(returnStatus) + " (" + gai_strerror(returnStatus) + ')');
+    this->setReadTimeout(this->readTimeoutDuration());
+    this->setWriteTimeout(this->writeTimeoutDuration());
+    this->flushRx();
+    this->m_isBound = false;
+}
+
+std::shared_ptr<const std::vector<ResolvedAddress>> AbstractSocket::resolveAddresses(const addrinfo &hints) {
+    //Cached, so a reconnect does not wait on DNS again
+    return HostResolver::instance().resolve(this->hostName(), this->portNumber(), hints);
+}
+
+std::shared_future<HostResolution> AbstractSocket::resolveAsync() {
+    return HostResolver::instance().resolveAsync(this->hostName(), this->portNumber(), this->getAddressInfoHints());
+}
+
+void AbstractSocket::connectToAny(const std::vector<ResolvedAddress> &addresses, std::chrono::steady_clock::time_point deadline) {
+    //Try every address the name resolved to, in the order the resolver returned them
+    std::string lastError{""};
+    for (const auto &address : addresses) {
+        if ( (!lastError.empty()) && (std::chrono::steady_clock::now() >= deadline) ) {
+            break;
+        }
+        try {
+            this->connectTo(address);
+            return;
+        } catch (std::exception &e) {
+            lastError = e.what();
+            if (this->isConnected()) {
+                this->disconnect();
+            }
+        }
     }
+    throw std::runtime_error("CppSerialPort::AbstractSocket::connectToAny(const std::vector<ResolvedAddress> &, std::chrono::steady_clock::time_point): Could not connect to any of the " + toStdString(addresses.size()) + " addresses for " + this->hostName() + ':' + toStdString(this->portNumber()) + ", last error: " + lastError);
+}
 
+void AbstractSocket::adoptConnection(socket_t socketDescriptor, const ResolvedAddress &address) {
+    this->m_socketDescriptor = socketDescriptor;
+    //Keep a copy of the address, since doConnect() and doWrite() use it
+    memset(&this->m_addressInfo, 0, sizeof(this->m_addressInfo));
+    this->m_addressInfo.ai_family = address.family;
+    this->m_addressInfo.ai_socktype = address.socketType;
+    this->m_addressInfo.ai_protocol = address.protocol;
+    this->m_peerAddress = address.address;
+    this->m_addressInfo.ai_addr = reinterpret_cast<sockaddr *>(&this->m_peerAddress);
+    this->m_addressInfo.ai_addrlen = address.addressLength;
+}
+
+void AbstractSocket::setConnectTimeout(std::chrono::microseconds timeout) {
+    this->m_connectTimeout = timeout;
+}
+
+std::chrono::microseconds AbstractSocket::connectTimeout() const {
+    return this->m_connectTimeout;
+}
+
+void AbstractSocket::connectTo(const ResolvedAddress &address) {
     //Create a socket
-    auto socketDescriptor = socket(addressInfo->ai_family, addressInfo->ai_socktype, addressInfo->ai_protocol);
+    auto socketDescriptor = socket(address.family, address.socketType, address.protocol);
     if (socketDescriptor == INVALID_SOCKET) {
-        freeaddrinfo(addressInfo);
         auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::AbstractSocket::connect(): socket(int, int, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        throw std::runtime_error("CppSerialPort::AbstractSocket::connectTo(const ResolvedAddress &): socket(int, int, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
     }
-    this->m_socketDescriptor = socketDescriptor;
+    this->adoptConnection(socketDescriptor, address);
 
     //Let the kernel reuse the socket if I close it
     sockopt_t acceptReuse{1};
     auto reuseSocketResult = setsockopt(this->m_socketDescriptor, SOL_SOCKET,  SO_REUSEADDR, &acceptReuse, sizeof(decltype(acceptReuse)));
     if (reuseSocketResult == -1) {
-        freeaddrinfo(addressInfo);
         auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::AbstractSocket::connect(): Setting reuse of socket: setsockopt(int, int, int, const void *, socklen_t): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-    this->m_addressInfo = *addressInfo;
-    try {
-        this->doConnect();
-    } catch (std::exception &e) {
-        freeaddrinfo(addressInfo);
-        std::rethrow_exception(std::current_exception());
+        throw std::runtime_error("CppSerialPort::AbstractSocket::connectTo(const ResolvedAddress &): Setting reuse of socket: setsockopt(int, int, int, const void *, socklen_t): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
     }
-
-    this->setReadTimeout(this->readTimeout());
-    this->setWriteTimeout(this->writeTimeout());
-
-    //Free address info
-    freeaddrinfo(addressInfo);
-    this->flushRx();
-    this->m_isBound = false;
-
+    this->applySocketOptions(this->m_socketOptions);
+    this->doConnect();
 }
 
 const addrinfo *AbstractSocket::addressInfo() {
     return &this->m_addressInfo;
 }
 
-void AbstractSocket::setReadTimeout(int timeout) {
+void AbstractSocket::setReadTimeout(std::chrono::microseconds timeout) {
     if (!this->isConnected()) {
         return IByteStream::setReadTimeout(timeout);
     }
     //SocketInterface read timeout
-    auto tv = toTimeVal(static_cast<uint32_t>(this->readTimeout()));
+    auto tv = toTimeVal(timeout);
     auto readTimeoutResult = setsockopt(this->m_socketDescriptor, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&tv), sizeof(struct timeval));
     if (readTimeoutResult == -1) {
         auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::AbstractSocket::setReadTimeout(): Setting read timeout (" + toStdString(this->readTimeout()) + "): setsockopt(int, int, int, const void *, int) set read timeout failed: error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        throw std::runtime_error("CppSerialPort::AbstractSocket::setReadTimeout(std::chrono::microseconds): Setting read timeout (" + toStdString(timeout.count()) + "us): setsockopt(int, int, int, const void *, int) set read timeout failed: error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
     }
     return IByteStream::setReadTimeout(timeout);
 }
 
-void AbstractSocket::setWriteTimeout(int timeout) {
+void AbstractSocket::setWriteTimeout(std::chrono::microseconds timeout) {
     if (!this->isConnected()) {
         return IByteStream::setWriteTimeout(timeout);
     }
     //SocketInterface write timeout
-    auto tv = toTimeVal(static_cast<uint32_t>(this->writeTimeout()));
+    auto tv = toTimeVal(timeout);
     auto writeTimeoutResult = setsockopt(this->m_socketDescriptor, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char *>(&tv), sizeof(struct timeval));
     if (writeTimeoutResult == -1) {
         auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::AbstractSocket::connect(): Setting write timeout(" + toStdString(this->writeTimeout())  + "): setsockopt(int, int, int, const void *, int) set write timeout failed: error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        throw std::runtime_error("CppSerialPort::AbstractSocket::setWriteTimeout(std::chrono::microseconds): Setting write timeout (" + toStdString(timeout.count()) + "us): setsockopt(int, int, int, const void *, int) set write timeout failed: error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
     }
     return IByteStream::setWriteTimeout(timeout);
 }
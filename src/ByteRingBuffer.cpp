@@ -0,0 +1,235 @@
+#include <CppSerialPort/ByteRingBuffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    size_t nextPowerOfTwo(size_t value) {
+        size_t returnValue{1};
+        while (returnValue < value) {
+            returnValue <<= 1;
+        }
+        return returnValue;
+    }
+}
+
+namespace CppSerialPort {
+
+const size_t ByteRingBuffer::DEFAULT_CAPACITY{4096};
+
+ByteRingBuffer::ByteRingBuffer() :
+    m_buffer{},
+    m_head{0},
+    m_size{0}
+{
+
+}
+
+ByteRingBuffer::ByteRingBuffer(size_t initialCapacity) :
+    ByteRingBuffer{}
+{
+    this->reserve(initialCapacity);
+}
+
+size_t ByteRingBuffer::physicalIndex(size_t index) const {
+    //Capacity is always a power of two, so wrapping is a mask instead of a modulo
+    return (this->m_head + index) & (this->m_buffer.size() - 1);
+}
+
+void ByteRingBuffer::grow(size_t minimumCapacity) {
+    if (minimumCapacity <= this->m_buffer.size()) {
+        return;
+    }
+    std::vector<char> newBuffer(nextPowerOfTwo(std::max(minimumCapacity, DEFAULT_CAPACITY)));
+    this->peek(newBuffer.data(), this->m_size);
+    this->m_buffer.swap(newBuffer);
+    this->m_head = 0;
+}
+
+ByteRingBuffer &ByteRingBuffer::reserve(size_t capacity) {
+    this->grow(capacity);
+    return *this;
+}
+
+ByteRingBuffer &ByteRingBuffer::append(char c) {
+    this->grow(this->m_size + 1);
+    this->m_buffer[this->physicalIndex(this->m_size)] = c;
+    this->m_size++;
+    return *this;
+}
+
+ByteRingBuffer &ByteRingBuffer::append(const char *bytes, size_t length) {
+    if (length == 0) {
+        return *this;
+    }
+    this->grow(this->m_size + length);
+    auto tail = this->physicalIndex(this->m_size);
+    auto firstPart = std::min(length, this->m_buffer.size() - tail);
+    memcpy(this->m_buffer.data() + tail, bytes, firstPart);
+    memcpy(this->m_buffer.data(), bytes + firstPart, length - firstPart);
+    this->m_size += length;
+    return *this;
+}
+
+ByteRingBuffer &ByteRingBuffer::append(const ByteArray &byteArray) {
+    return this->append(byteArray.data(), byteArray.length());
+}
+
+std::pair<char *, size_t> ByteRingBuffer::writeSpan(size_t minimum) {
+    //Free space right after the last byte, so a device can read straight into the buffer
+    //The span can be shorter than minimum when the free space wraps around, which only means a shorter read
+    this->grow(this->m_size + std::max<size_t>(minimum, 1));
+    auto tail = this->physicalIndex(this->m_size);
+    return std::make_pair(this->m_buffer.data() + tail, std::min(this->m_buffer.size() - this->m_size, this->m_buffer.size() - tail));
+}
+
+ByteRingBuffer &ByteRingBuffer::commitWrite(size_t count) {
+    if (count > this->m_buffer.size() - this->m_size) {
+        throw std::runtime_error("CppSerialPort::ByteRingBuffer::commitWrite(size_t): count cannot be greater than free space (" + std::to_string(count) + " > " + std::to_string(this->m_buffer.size() - this->m_size) + ")");
+    }
+    this->m_size += count;
+    return *this;
+}
+
+size_t ByteRingBuffer::peek(char *buffer, size_t maximum) const {
+    auto count = std::min(maximum, this->m_size);
+    if (count == 0) {
+        return 0;
+    }
+    auto firstPart = std::min(count, this->m_buffer.size() - this->m_head);
+    memcpy(buffer, this->m_buffer.data() + this->m_head, firstPart);
+    memcpy(buffer + firstPart, this->m_buffer.data(), count - firstPart);
+    return count;
+}
+
+size_t ByteRingBuffer::read(char *buffer, size_t maximum) {
+    auto count = this->peek(buffer, maximum);
+    this->consume(count);
+    return count;
+}
+
+ByteArray ByteRingBuffer::read(size_t maximum) {
+    std::vector<char> bytes(std::min(maximum, this->m_size));
+    this->read(bytes.data(), bytes.size());
+    ByteArray returnArray{};
+    returnArray = std::move(bytes);
+    return returnArray;
+}
+
+ByteRingBuffer &ByteRingBuffer::consume(size_t count) {
+    if (count > this->m_size) {
+        throw std::runtime_error("CppSerialPort::ByteRingBuffer::consume(size_t): count cannot be greater than current size (" + std::to_string(count) + " > " + std::to_string(this->m_size) + ")");
+    }
+    this->m_size -= count;
+    //Rewind an empty buffer so the next append starts contiguous
+    this->m_head = (this->m_size == 0) ? 0 : this->physicalIndex(count);
+    return *this;
+}
+
+char ByteRingBuffer::front() const {
+    return this->at(0);
+}
+
+char ByteRingBuffer::takeFront() {
+    char returnValue{this->front()};
+    this->consume(1);
+    return returnValue;
+}
+
+std::pair<const char *, size_t> ByteRingBuffer::frontSpan() const {
+    if (this->m_size == 0) {
+        return std::make_pair(nullptr, 0);
+    }
+    return std::make_pair(this->m_buffer.data() + this->m_head, std::min(this->m_size, this->m_buffer.size() - this->m_head));
+}
+
+const char *ByteRingBuffer::linearize() {
+    if (this->m_head + this->m_size > this->m_buffer.size()) {
+        std::vector<char> newBuffer(this->m_buffer.size());
+        this->peek(newBuffer.data(), this->m_size);
+        this->m_buffer.swap(newBuffer);
+        this->m_head = 0;
+    }
+    return this->m_buffer.data() + this->m_head;
+}
+
+size_t ByteRingBuffer::find(char c, size_t from) const {
+    if (from >= this->m_size) {
+        return std::string::npos;
+    }
+    auto start = this->physicalIndex(from);
+    auto remaining = this->m_size - from;
+    auto firstPart = std::min(remaining, this->m_buffer.size() - start);
+    auto found = static_cast<const char *>(memchr(this->m_buffer.data() + start, c, firstPart));
+    if (found) {
+        return from + static_cast<size_t>(found - (this->m_buffer.data() + start));
+    }
+    found = static_cast<const char *>(memchr(this->m_buffer.data(), c, remaining - firstPart));
+    if (found) {
+        return from + firstPart + static_cast<size_t>(found - this->m_buffer.data());
+    }
+    return std::string::npos;
+}
+
+size_t ByteRingBuffer::find(const char *pattern, size_t length, size_t from) const {
+    if (length == 0) {
+        return (from <= this->m_size) ? from : std::string::npos;
+    }
+    //memchr to the next candidate first byte, then compare the rest in place
+    while (from + length <= this->m_size) {
+        auto candidate = this->find(pattern[0], from);
+        if ( (candidate == std::string::npos) || (candidate + length > this->m_size) ) {
+            return std::string::npos;
+        }
+        size_t matched{1};
+        while ( (matched < length) && (this->operator[](candidate + matched) == pattern[matched]) ) {
+            matched++;
+        }
+        if (matched == length) {
+            return candidate;
+        }
+        from = candidate + 1;
+    }
+    return std::string::npos;
+}
+
+size_t ByteRingBuffer::find(const ByteArray &pattern, size_t from) const {
+    return this->find(pattern.data(), pattern.length(), from);
+}
+
+const char &ByteRingBuffer::operator[](size_t index) const {
+    return this->m_buffer[this->physicalIndex(index)];
+}
+
+const char &ByteRingBuffer::at(size_t index) const {
+    if (index >= this->m_size) {
+        throw std::out_of_range("CppSerialPort::ByteRingBuffer::at(size_t): index out of range (" + std::to_string(index) + " >= " + std::to_string(this->m_size) + ")");
+    }
+    return this->operator[](index);
+}
+
+ByteRingBuffer &ByteRingBuffer::clear() {
+    this->m_head = 0;
+    this->m_size = 0;
+    return *this;
+}
+
+size_t ByteRingBuffer::size() const {
+    return this->m_size;
+}
+
+size_t ByteRingBuffer::length() const {
+    return this->m_size;
+}
+
+size_t ByteRingBuffer::capacity() const {
+    return this->m_buffer.size();
+}
+
+bool ByteRingBuffer::empty() const {
+    return this->m_size == 0;
+}
+
+} //namespace CppSerialPort
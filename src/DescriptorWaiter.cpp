@@ -0,0 +1,97 @@
+#include <CppSerialPort/DescriptorWaiter.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#if defined(_WIN32)
+#    include <winsock2.h>
+#else
+#    include <cerrno>
+#    include <poll.h>
+#endif //defined(_WIN32)
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using NetworkErrorInformation::getLastError;
+using NetworkErrorInformation::getErrorString;
+
+namespace CppSerialPort {
+
+bool DescriptorWaiter::waitForReadable(descriptor_t descriptor, std::chrono::steady_clock::time_point deadline) {
+    return (wait(descriptor, POLLIN, deadline) != 0);
+}
+
+bool DescriptorWaiter::waitForWritable(descriptor_t descriptor, std::chrono::steady_clock::time_point deadline) {
+    return (wait(descriptor, POLLOUT, deadline) != 0);
+}
+
+short DescriptorWaiter::wait(descriptor_t descriptor, short events, std::chrono::steady_clock::time_point deadline) {
+#if defined(_WIN32)
+    WSAPOLLFD pollDescriptor{};
+#else
+    pollfd pollDescriptor{};
+#endif //defined(_WIN32)
+    pollDescriptor.fd = descriptor;
+    pollDescriptor.events = events;
+    return (pollDescriptors(&pollDescriptor, 1, deadline) == 0) ? static_cast<short>(0) : pollDescriptor.revents;
+}
+
+size_t DescriptorWaiter::waitForAny(const descriptor_t *descriptors, size_t count, short events, std::chrono::steady_clock::time_point deadline) {
+#if defined(_WIN32)
+    std::vector<WSAPOLLFD> pollDescriptorList(count);
+#else
+    std::vector<pollfd> pollDescriptorList(count);
+#endif //defined(_WIN32)
+    for (size_t i = 0; i < count; i++) {
+        pollDescriptorList[i].fd = descriptors[i];
+        pollDescriptorList[i].events = events;
+    }
+    return pollDescriptors(pollDescriptorList.data(), count, deadline);
+}
+
+size_t DescriptorWaiter::waitForEach(const descriptor_t *descriptors, const short *events, short *returnedEvents, size_t count, std::chrono::steady_clock::time_point deadline) {
+#if defined(_WIN32)
+    std::vector<WSAPOLLFD> pollDescriptorList(count);
+#else
+    std::vector<pollfd> pollDescriptorList(count);
+#endif //defined(_WIN32)
+    for (size_t i = 0; i < count; i++) {
+        pollDescriptorList[i].fd = descriptors[i];
+        pollDescriptorList[i].events = events[i];
+    }
+    auto readyCount = pollDescriptors(pollDescriptorList.data(), count, deadline);
+    for (size_t i = 0; i < count; i++) {
+        returnedEvents[i] = (readyCount == 0) ? static_cast<short>(0) : pollDescriptorList[i].revents;
+    }
+    return readyCount;
+}
+
+size_t DescriptorWaiter::pollDescriptors(void *pollDescriptorList, size_t count, std::chrono::steady_clock::time_point deadline) {
+#if defined(_WIN32)
+    auto pollDescriptorArray = static_cast<WSAPOLLFD *>(pollDescriptorList);
+#else
+    auto pollDescriptorArray = static_cast<pollfd *>(pollDescriptorList);
+#endif //defined(_WIN32)
+    int pollResult{0};
+    do {
+        //Recomputed on every pass, so a signal interrupting the wait does not extend it
+        auto remaining = std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()), std::chrono::nanoseconds{0});
+#if defined(_WIN32)
+        pollResult = WSAPoll(pollDescriptorArray, static_cast<ULONG>(count), static_cast<INT>((remaining.count() + 999999) / 1000000));
+#elif defined(__linux__)
+        timespec pollTimeout{static_cast<time_t>(remaining.count() / 1000000000), static_cast<long>(remaining.count() % 1000000000)};
+        pollResult = ppoll(pollDescriptorArray, static_cast<nfds_t>(count), &pollTimeout, nullptr);
+#else
+        pollResult = poll(pollDescriptorArray, static_cast<nfds_t>(count), static_cast<int>((remaining.count() + 999999) / 1000000));
+#endif //defined(_WIN32)
+    } while ( (pollResult == -1) && (getLastError() == EINTR) );
+
+    if (pollResult == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::DescriptorWaiter::pollDescriptors(void *, size_t, std::chrono::steady_clock::time_point): poll failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    return static_cast<size_t>(pollResult);
+}
+
+} //namespace CppSerialPort
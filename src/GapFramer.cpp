@@ -0,0 +1,133 @@
+#include <CppSerialPort/GapFramer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace CppSerialPort {
+
+const size_t GapFramer::DEFAULT_MAXIMUM_FRAME_SIZE{65536};
+
+GapFramer::GapFramer(IByteStream &stream, std::chrono::microseconds gap) :
+    m_stream{stream},
+    m_gap{},
+    m_maximumFrameSize{DEFAULT_MAXIMUM_FRAME_SIZE},
+    m_frame{},
+    m_heldChunk{},
+    m_hasHeldChunk{false}
+{
+    this->setGap(gap);
+}
+
+GapFramer::Frame GapFramer::readFrame(bool *timeout) {
+    return this->readFrame(std::chrono::steady_clock::now() + this->m_stream.readTimeoutDuration(), timeout);
+}
+
+GapFramer::Frame GapFramer::readFrame(std::chrono::steady_clock::time_point deadline, bool *timeout) {
+    if (timeout) {
+        *timeout = false;
+    }
+    while (true) {
+        TimestampedChunk chunk{};
+        if (this->m_hasHeldChunk) {
+            chunk = std::move(this->m_heldChunk);
+            this->m_hasHeldChunk = false;
+        } else {
+            //While a frame is open, only wait as long as the gap that would close it
+            auto waitUntil = deadline;
+            if (!this->m_frame.data.empty()) {
+                waitUntil = std::min(deadline, this->m_frame.lastChunk + this->m_gap);
+            }
+            bool chunkTimedOut{false};
+            chunk = this->m_stream.readChunk(waitUntil, &chunkTimedOut);
+            if ( (chunkTimedOut) || (chunk.data.empty()) ) {
+                auto now = std::chrono::steady_clock::now();
+                if ( (!this->m_frame.data.empty()) && (now >= this->m_frame.lastChunk + this->m_gap) ) {
+                    return this->takeFrame();
+                }
+                if (now >= deadline) {
+                    if (timeout) {
+                        *timeout = true;
+                    }
+                    return Frame{};
+                }
+                continue;
+            }
+        }
+        //Streams without timestamped capture leave the steady time at zero, so use the hand over time instead
+        auto received = chunk.timestamp.steady;
+        if (received == std::chrono::steady_clock::time_point{}) {
+            received = std::chrono::steady_clock::now();
+        }
+        if ( (!this->m_frame.data.empty()) && (received - this->m_frame.lastChunk >= this->m_gap) ) {
+            //This chunk starts the next frame
+            this->m_heldChunk = std::move(chunk);
+            this->m_heldChunk.timestamp.steady = received;
+            this->m_hasHeldChunk = true;
+            return this->takeFrame();
+        }
+        if (this->addChunk(chunk.data, received)) {
+            return this->takeFrame();
+        }
+    }
+}
+
+bool GapFramer::addChunk(const ByteArray &data, std::chrono::steady_clock::time_point received) {
+    if (this->m_frame.data.empty()) {
+        this->m_frame.firstChunk = received;
+    }
+    this->m_frame.data.append(data);
+    this->m_frame.lastChunk = received;
+    return this->m_frame.data.size() >= this->m_maximumFrameSize;
+}
+
+GapFramer::Frame GapFramer::takeFrame() {
+    auto returnFrame = std::move(this->m_frame);
+    this->m_frame = Frame{};
+    return returnFrame;
+}
+
+void GapFramer::reset() {
+    this->m_frame = Frame{};
+    this->m_heldChunk = TimestampedChunk{};
+    this->m_hasHeldChunk = false;
+}
+
+void GapFramer::setGap(std::chrono::microseconds gap) {
+    if (gap.count() <= 0) {
+        throw std::runtime_error("CppSerialPort::GapFramer::setGap(std::chrono::microseconds): gap must be greater than 0 (" + std::to_string(gap.count()) + "us)");
+    }
+    this->m_gap = gap;
+}
+
+std::chrono::microseconds GapFramer::gap() const {
+    return this->m_gap;
+}
+
+void GapFramer::setMaximumFrameSize(size_t maximumFrameSize) {
+    if (maximumFrameSize == 0) {
+        throw std::runtime_error("CppSerialPort::GapFramer::setMaximumFrameSize(size_t): maximumFrameSize must be greater than 0");
+    }
+    this->m_maximumFrameSize = maximumFrameSize;
+}
+
+size_t GapFramer::maximumFrameSize() const {
+    return this->m_maximumFrameSize;
+}
+
+std::chrono::microseconds GapFramer::characterTime(uint32_t baudRate, unsigned int bitsPerCharacter) {
+    if (baudRate == 0) {
+        throw std::runtime_error("CppSerialPort::GapFramer::characterTime(uint32_t, unsigned int): baudRate must be greater than 0");
+    }
+    //Rounded up, so a gap built from it is never shorter than the line needs
+    return std::chrono::microseconds{(static_cast<uint64_t>(bitsPerCharacter) * 1000000 + baudRate - 1) / baudRate};
+}
+
+std::chrono::microseconds GapFramer::modbusRtuGap(uint32_t baudRate) {
+    if (baudRate > 19200) {
+        return std::chrono::microseconds{1750};
+    }
+    return std::chrono::microseconds{(characterTime(baudRate).count() * 7 + 1) / 2};
+}
+
+} //namespace CppSerialPort
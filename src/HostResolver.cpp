@@ -0,0 +1,174 @@
+#include <CppSerialPort/HostResolver.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace CppSerialPort {
+
+const std::chrono::seconds HostResolver::DEFAULT_TIME_TO_LIVE{60};
+const std::chrono::seconds HostResolver::DEFAULT_NEGATIVE_TIME_TO_LIVE{5};
+const std::chrono::seconds HostResolver::DEFAULT_MAXIMUM_STALENESS{600};
+
+HostResolver::HostResolver() :
+    m_mutex{},
+    m_entries{},
+    m_timeToLive{DEFAULT_TIME_TO_LIVE},
+    m_negativeTimeToLive{DEFAULT_NEGATIVE_TIME_TO_LIVE},
+    m_maximumStaleness{DEFAULT_MAXIMUM_STALENESS}
+{
+
+}
+
+HostResolver &HostResolver::instance() {
+    static HostResolver resolver{};
+    return resolver;
+}
+
+std::shared_ptr<const std::vector<ResolvedAddress>> HostResolver::resolve(const std::string &hostName, uint16_t portNumber, const addrinfo &hints) {
+    auto resolution = this->resolveAsync(hostName, portNumber, hints).get();
+    if (!resolution.addresses) {
+        throw std::runtime_error("CppSerialPort::HostResolver::resolve(const std::string &, uint16_t, const addrinfo &): " + resolution.error);
+    }
+    return resolution.addresses;
+}
+
+std::shared_future<HostResolution> HostResolver::resolveAsync(const std::string &hostName, uint16_t portNumber, const addrinfo &hints) {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    auto &entry = this->m_entries[makeKey(hostName, portNumber, hints)];
+    entry.hostName = hostName;
+    this->collect(entry);
+
+    auto now = std::chrono::steady_clock::now();
+    auto usable = ( (entry.hasResolution) && (now < entry.expiresAt) );
+    auto stale = ( (entry.hasResolution) && (entry.resolution.addresses) && (now < entry.staleUntil) );
+    if ( (!usable) && (!entry.pending.valid()) ) {
+        //The lookup owns copies of everything it uses, and only touches the cache through collect(), so it never outlives what it refers to
+        auto hintsCopy = hints;
+        hintsCopy.ai_addr = nullptr;
+        hintsCopy.ai_canonname = nullptr;
+        hintsCopy.ai_next = nullptr;
+        entry.pending = std::async(std::launch::async, &HostResolver::lookup, hostName, portNumber, hintsCopy).share();
+    }
+    if ( (usable) || (stale) ) {
+        return makeReady(entry.resolution);
+    }
+    return entry.pending;
+}
+
+void HostResolver::collect(Entry &entry) {
+    if ( (!entry.pending.valid()) || (entry.pending.wait_for(std::chrono::seconds{0}) != std::future_status::ready) ) {
+        return;
+    }
+    auto resolution = entry.pending.get();
+    entry.pending = std::shared_future<HostResolution>{};
+    if (resolution.addresses) {
+        entry.resolution = resolution;
+        entry.hasResolution = true;
+        entry.expiresAt = resolution.completedAt + this->m_timeToLive;
+        entry.staleUntil = entry.expiresAt + this->m_maximumStaleness;
+    } else if ( (entry.hasResolution) && (entry.resolution.addresses) && (resolution.completedAt < entry.staleUntil) ) {
+        //Keep serving the last good addresses through a resolver outage, and try again after the negative time to live
+        entry.expiresAt = resolution.completedAt + this->m_negativeTimeToLive;
+    } else {
+        entry.resolution = resolution;
+        entry.hasResolution = true;
+        entry.expiresAt = resolution.completedAt + this->m_negativeTimeToLive;
+        entry.staleUntil = entry.expiresAt;
+    }
+}
+
+HostResolution HostResolver::lookup(const std::string &hostName, uint16_t portNumber, const addrinfo &hints) {
+    HostResolution resolution{};
+    addrinfo *addressInfo{nullptr};
+    auto returnStatus = getaddrinfo(hostName.c_str(), std::to_string(portNumber).c_str(), &hints, &addressInfo);
+    resolution.completedAt = std::chrono::steady_clock::now();
+    if (returnStatus != 0) {
+        resolution.error = "getaddrinfo(const char *, const char *, const addrinfo *, addrinfo **) for " + hostName + ':' + std::to_string(portNumber) + ": error code " + std::to_string(returnStatus) + " (" + gai_strerror(returnStatus) + ')';
+        return resolution;
+    }
+    auto addresses = std::make_shared<std::vector<ResolvedAddress>>();
+    for (auto it = addressInfo; it != nullptr; it = it->ai_next) {
+        ResolvedAddress resolvedAddress{};
+        resolvedAddress.family = it->ai_family;
+        resolvedAddress.socketType = it->ai_socktype;
+        resolvedAddress.protocol = it->ai_protocol;
+        resolvedAddress.addressLength = static_cast<socklen_t>(std::min<size_t>(it->ai_addrlen, sizeof(resolvedAddress.address)));
+        memcpy(&resolvedAddress.address, it->ai_addr, resolvedAddress.addressLength);
+        addresses->push_back(resolvedAddress);
+    }
+    freeaddrinfo(addressInfo);
+    if (addresses->empty()) {
+        resolution.error = "getaddrinfo(const char *, const char *, const addrinfo *, addrinfo **) for " + hostName + ':' + std::to_string(portNumber) + ": no addresses returned";
+        return resolution;
+    }
+    resolution.addresses = addresses;
+    return resolution;
+}
+
+void HostResolver::invalidate(const std::string &hostName) {
+    //Dropping the last reference to a running lookup waits for it, so that happens after the lock is released
+    std::vector<Entry> removedEntries{};
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    for (auto iter = this->m_entries.begin(); iter != this->m_entries.end(); ) {
+        if (iter->second.hostName == hostName) {
+            removedEntries.push_back(std::move(iter->second));
+            iter = this->m_entries.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+}
+
+void HostResolver::clear() {
+    decltype(this->m_entries) removedEntries{};
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    removedEntries.swap(this->m_entries);
+}
+
+size_t HostResolver::size() const {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    return this->m_entries.size();
+}
+
+void HostResolver::setTimeToLive(std::chrono::seconds timeToLive) {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    this->m_timeToLive = timeToLive;
+}
+
+std::chrono::seconds HostResolver::timeToLive() const {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    return this->m_timeToLive;
+}
+
+void HostResolver::setNegativeTimeToLive(std::chrono::seconds negativeTimeToLive) {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    this->m_negativeTimeToLive = negativeTimeToLive;
+}
+
+std::chrono::seconds HostResolver::negativeTimeToLive() const {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    return this->m_negativeTimeToLive;
+}
+
+void HostResolver::setMaximumStaleness(std::chrono::seconds maximumStaleness) {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    this->m_maximumStaleness = maximumStaleness;
+}
+
+std::chrono::seconds HostResolver::maximumStaleness() const {
+    std::lock_guard<std::mutex> entryLock{this->m_mutex};
+    return this->m_maximumStaleness;
+}
+
+std::string HostResolver::makeKey(const std::string &hostName, uint16_t portNumber, const addrinfo &hints) {
+    return hostName + '|' + std::to_string(portNumber) + '|' + std::to_string(hints.ai_family) + '|' + std::to_string(hints.ai_socktype) + '|' + std::to_string(hints.ai_protocol) + '|' + std::to_string(hints.ai_flags);
+}
+
+std::shared_future<HostResolution> HostResolver::makeReady(const HostResolution &resolution) {
+    std::promise<HostResolution> promise{};
+    promise.set_value(resolution);
+    return promise.get_future().share();
+}
+
+} //namespace CppSerialPort
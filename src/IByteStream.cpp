@@ -1,4 +1,5 @@
 #include <CppSerialPort/IByteStream.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -13,6 +14,11 @@ const char *CppSerialPort::IByteStream::DEFAULT_LINE_ENDING{"\n"};
 #endif //defined(_WIN32)
 
 namespace {
+    //Whole milliseconds, rounded up so a sub-millisecond timeout is never reported as 0 (which means do not wait)
+    int toMilliseconds(std::chrono::microseconds timeout) {
+        return static_cast<int>((timeout.count() + 999) / 1000);
+    }
+
     template <typename InputType> static std::string toFixedWidthHex(InputType value, size_t targetLength, bool includeZeroX = true) {
         std::stringstream returnString{};
         if (includeZeroX) {
@@ -32,11 +38,16 @@ const int IByteStream::DEFAULT_READ_TIMEOUT{1000};
 const int IByteStream::DEFAULT_WRITE_TIMEOUT{1000};
 
 IByteStream::IByteStream() :
-	m_readTimeout{ DEFAULT_READ_TIMEOUT },
-	m_writeTimeout{ DEFAULT_WRITE_TIMEOUT },
+	m_readTimeout{ std::chrono::milliseconds{DEFAULT_READ_TIMEOUT} },
+	m_writeTimeout{ std::chrono::milliseconds{DEFAULT_WRITE_TIMEOUT} },
 	m_lineEnding{ DEFAULT_LINE_ENDING },
+	m_readBuffer{},
 	m_writeMutex{},
-	m_readMutex{}
+	m_readMutex{},
+	m_chunkTimestamping{false},
+	m_chunkTimestamps{},
+	m_bufferedByteCount{0},
+	m_lastReceiveTimestamp{}
 {
 
 }
@@ -45,25 +56,54 @@ void IByteStream::setReadTimeout(int timeout) {
     if (timeout < 0) {
         throw std::runtime_error("CppSerialPort::IByteStream::setReadTimeout(int): invariant failure (read timeout cannot be less than 0, " + toStdString(timeout) + " < 0)");
     }
+    this->setReadTimeout(std::chrono::milliseconds{timeout});
+}
+
+void IByteStream::setReadTimeout(std::chrono::microseconds timeout) {
+    if (timeout.count() < 0) {
+        throw std::runtime_error("CppSerialPort::IByteStream::setReadTimeout(std::chrono::microseconds): invariant failure (read timeout cannot be less than 0, " + toStdString(timeout.count()) + "us < 0)");
+    }
     this->m_readTimeout = timeout;
 }
 
 int IByteStream::readTimeout() const {
-    return this->m_readTimeout;
+    return toMilliseconds(this->m_readTimeout);
+}
 
+std::chrono::microseconds IByteStream::readTimeoutDuration() const {
+    return this->m_readTimeout;
 }
 
 void IByteStream::setWriteTimeout(int timeout) {
     if (timeout < 0) {
         throw std::runtime_error("CppSerialPort::IByteStream::setWriteTimeout(int): invariant failure (write timeout cannot be less than 0, " + toStdString(timeout) + " < 0)");
     }
+    this->setWriteTimeout(std::chrono::milliseconds{timeout});
+}
+
+void IByteStream::setWriteTimeout(std::chrono::microseconds timeout) {
+    if (timeout.count() < 0) {
+        throw std::runtime_error("CppSerialPort::IByteStream::setWriteTimeout(std::chrono::microseconds): invariant failure (write timeout cannot be less than 0, " + toStdString(timeout.count()) + "us < 0)");
+    }
     this->m_writeTimeout = timeout;
 }
 
 int IByteStream::writeTimeout() const {
+    return toMilliseconds(this->m_writeTimeout);
+}
+
+std::chrono::microseconds IByteStream::writeTimeoutDuration() const {
     return this->m_writeTimeout;
 }
 
+std::chrono::steady_clock::time_point IByteStream::deadlineAfter(std::chrono::microseconds timeout) {
+    return std::chrono::steady_clock::now() + timeout;
+}
+
+int IByteStream::fileDescriptor() const {
+    return -1;
+}
+
 ByteArray IByteStream::lineEnding() const {
     return this->m_lineEnding;
 }
@@ -91,10 +131,8 @@ void IByteStream::setLineEnding(char chr) {
 
 ssize_t IByteStream::writeLine(const std::string &str) {
     std::lock_guard<std::mutex> writeLock{this->m_writeMutex};
-	ByteArray toWrite{};
-    toWrite += str;
-    toWrite += this->lineEnding();
-	return this->write(toWrite.data(), toWrite.length());
+    const ConstBuffer buffers[]{ConstBuffer{str}, ConstBuffer{this->m_lineEnding}};
+    return this->writeBuffers(buffers, 2);
 }
 
 ssize_t IByteStream::write(const std::string &str) {
@@ -104,10 +142,8 @@ ssize_t IByteStream::write(const std::string &str) {
 
 ssize_t IByteStream::writeLine(const ByteArray &byteArray) {
     std::lock_guard<std::mutex> writeLock{this->m_writeMutex};
-    ByteArray toWrite{};
-    toWrite += byteArray;
-    toWrite += this->lineEnding();
-    return this->write(toWrite.data(), toWrite.length());
+    const ConstBuffer buffers[]{ConstBuffer{byteArray}, ConstBuffer{this->m_lineEnding}};
+    return this->writeBuffers(buffers, 2);
 }
 
 ssize_t IByteStream::write(const ByteArray &byteArray) {
@@ -115,36 +151,225 @@ ssize_t IByteStream::write(const ByteArray &byteArray) {
     return this->write(byteArray.data(), byteArray.length());
 }
 
+ssize_t IByteStream::write(std::initializer_list<ConstBuffer> buffers) {
+    std::lock_guard<std::mutex> writeLock{this->m_writeMutex};
+    return this->writeBuffers(buffers.begin(), buffers.size());
+}
+
+ssize_t IByteStream::write(const std::vector<ConstBuffer> &buffers) {
+    std::lock_guard<std::mutex> writeLock{this->m_writeMutex};
+    return this->writeBuffers(buffers.data(), buffers.size());
+}
+
+ssize_t IByteStream::writeBuffers(const ConstBuffer *buffers, size_t count) {
+    //Fallback for streams without a vectored write: gather into one buffer and write it once
+    std::vector<char> toWrite{};
+    for (size_t i = 0; i < count; i++) {
+        toWrite.insert(toWrite.end(), buffers[i].data, buffers[i].data + buffers[i].length);
+    }
+    return this->write(toWrite.data(), toWrite.size());
+}
+
+size_t IByteStream::read(char *buffer, size_t maximum, bool *timeout) {
+    return this->readWithin(buffer, maximum, deadlineAfter(this->m_readTimeout), timeout);
+}
+
+size_t IByteStream::read(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline, bool *timeout) {
+    return this->readWithin(buffer, maximum, deadline, timeout);
+}
+
+size_t IByteStream::tryRead(char *buffer, size_t maximum) {
+    return this->readWithin(buffer, maximum, std::chrono::steady_clock::now(), nullptr);
+}
+
+size_t IByteStream::readExactly(char *buffer, size_t count, bool *timeout) {
+    return this->readExactly(buffer, count, deadlineAfter(this->m_readTimeout), timeout);
+}
+
+size_t IByteStream::readExactly(char *buffer, size_t count, std::chrono::steady_clock::time_point deadline, bool *timeout) {
+    std::lock_guard<std::mutex> readLock{this->m_readMutex};
+    size_t readBytes{0};
+    do {
+        readBytes += this->readWithin(buffer + readBytes, count - readBytes, deadline, nullptr);
+    } while ( (readBytes < count) && (std::chrono::steady_clock::now() < deadline) );
+    if (timeout) {
+        *timeout = (readBytes < count);
+    }
+    return readBytes;
+}
+
+char IByteStream::read(bool *timeout) {
+    if ( (this->m_readBuffer.empty()) && (this->fillReadBuffer(deadlineAfter(this->m_readTimeout)) == 0) ) {
+        if (timeout) {
+            *timeout = true;
+        }
+        return 0;
+    }
+    if (timeout) {
+        *timeout = false;
+    }
+    return this->m_readBuffer.takeFront();
+}
+
+ByteArray IByteStream::readAvailable() {
+    this->fillReadBuffer(std::chrono::steady_clock::now());
+    return this->m_readBuffer.read(this->m_readBuffer.size());
+}
+
+size_t IByteStream::readWithin(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline, bool *timedOut) {
+    if (timedOut) {
+        *timedOut = false;
+    }
+    if (maximum == 0) {
+        return 0;
+    }
+    if ( (this->m_readBuffer.empty()) && (this->m_chunkTimestamping) ) {
+        //Bytes read past the buffer would throw their timestamps out of step
+        this->fillReadBuffer(deadline);
+    }
+    if (!this->m_readBuffer.empty()) {
+        return this->m_readBuffer.read(buffer, maximum);
+    }
+    if (this->m_chunkTimestamping) {
+        if (timedOut) {
+            *timedOut = true;
+        }
+        return 0;
+    }
+    //Nothing buffered, so read straight into the caller's buffer
+    auto returnSize = this->readFromDevice(buffer, maximum, deadline);
+    if ( (returnSize == 0) && (timedOut) ) {
+        *timedOut = true;
+    }
+    return returnSize;
+}
+
+size_t IByteStream::fillReadBuffer(std::chrono::steady_clock::time_point deadline) {
+    auto writeSpan = this->m_readBuffer.writeSpan(READ_CHUNK_SIZE);
+    auto returnSize = this->readFromDevice(writeSpan.first, writeSpan.second, deadline);
+    this->commitReadBuffer(returnSize);
+    if ( (this->m_chunkTimestamping) && (returnSize > 0) ) {
+        this->discardConsumedTimestamps();
+        this->m_chunkTimestamps.push_back(ChunkTimestamp{this->m_bufferedByteCount, this->m_lastReceiveTimestamp});
+    }
+    return returnSize;
+}
+
+void IByteStream::commitReadBuffer(size_t count) {
+    this->m_readBuffer.commitWrite(count);
+    this->m_bufferedByteCount += count;
+}
+
+TimestampedChunk IByteStream::readChunk(bool *timeout) {
+    return this->readChunk(deadlineAfter(this->m_readTimeout), timeout);
+}
+
+TimestampedChunk IByteStream::readChunk(std::chrono::steady_clock::time_point deadline, bool *timeout) {
+    if ( (this->m_readBuffer.empty()) && (this->fillReadBuffer(deadline) == 0) ) {
+        if (timeout) {
+            *timeout = true;
+        }
+        return TimestampedChunk{ByteArray{}, ReceiveTimestamp{}};
+    }
+    if (timeout) {
+        *timeout = false;
+    }
+    this->discardConsumedTimestamps();
+    if (this->m_chunkTimestamps.empty()) {
+        return TimestampedChunk{this->m_readBuffer.read(this->m_readBuffer.size()), ReceiveTimestamp{}};
+    }
+    auto chunkLength = std::min<uint64_t>(this->m_chunkTimestamps.front().end - this->consumedByteCount(), this->m_readBuffer.size());
+    auto chunkTimestamp = this->m_chunkTimestamps.front().timestamp;
+    return TimestampedChunk{this->m_readBuffer.read(static_cast<size_t>(chunkLength)), chunkTimestamp};
+}
+
+ReceiveTimestamp IByteStream::frontTimestamp() const {
+    auto consumed = this->consumedByteCount();
+    for (const auto &it : this->m_chunkTimestamps) {
+        if (it.end > consumed) {
+            return it.timestamp;
+        }
+    }
+    return ReceiveTimestamp{};
+}
+
+void IByteStream::setChunkTimestamping(bool chunkTimestamping) {
+    this->m_chunkTimestamping = chunkTimestamping;
+    if (!chunkTimestamping) {
+        this->m_chunkTimestamps.clear();
+    }
+}
+
+bool IByteStream::isChunkTimestamping() const {
+    return this->m_chunkTimestamping;
+}
+
+void IByteStream::setLastReceiveTimestamp(const ReceiveTimestamp &timestamp) {
+    this->m_lastReceiveTimestamp = timestamp;
+}
+
+uint64_t IByteStream::consumedByteCount() const {
+    //Bytes leave the read buffer through many paths, so consumption is worked out from what is left
+    return this->m_bufferedByteCount - this->m_readBuffer.size();
+}
+
+void IByteStream::discardConsumedTimestamps() {
+    auto consumed = this->consumedByteCount();
+    while ( (!this->m_chunkTimestamps.empty()) && (this->m_chunkTimestamps.front().end <= consumed) ) {
+        this->m_chunkTimestamps.pop_front();
+    }
+}
+
+ByteRingBuffer &IByteStream::readBuffer() {
+    return this->m_readBuffer;
+}
+
+const ByteRingBuffer &IByteStream::readBuffer() const {
+    return this->m_readBuffer;
+}
+
 ByteArray IByteStream::readLine(bool *timeout) {
     return this->readUntil(this->m_lineEnding, timeout);
 }
 
+ByteArray IByteStream::readLine(std::chrono::steady_clock::time_point deadline, bool *timeout) {
+    return this->readUntil(this->m_lineEnding, deadline, timeout);
+}
+
 ByteArray IByteStream::readUntil(const std::string &until, bool *timeout) {
     return this->readUntil(ByteArray{until}, timeout);
 }
 
 ByteArray IByteStream::readUntil(const ByteArray &until, bool *timeout) {
+    return this->readUntil(until, deadlineAfter(this->m_readTimeout), timeout);
+}
+
+ByteArray IByteStream::readUntil(const ByteArray &until, std::chrono::steady_clock::time_point deadline, bool *timeout) {
 	std::lock_guard<std::mutex> readLock{ this->m_readMutex };
-    auto startTime = IByteStream::getEpoch();
-    ByteArray returnArray{""};
     if (timeout) {
         *timeout = false;
     }
-    do {
-        bool readTimeout{false};
-        char maybeChar{this->read(&readTimeout)};
-        if (readTimeout) {
-            continue;
+    size_t searchFrom{0};
+    while (true) {
+        auto foundIndex = this->m_readBuffer.find(until, searchFrom);
+        if (foundIndex != std::string::npos) {
+            auto returnArray = this->m_readBuffer.read(foundIndex);
+            this->m_readBuffer.consume(until.length());
+            return returnArray;
+        }
+        //Only the last (until.length() - 1) bytes can still begin a delimiter, so never rescan the rest
+        if (this->m_readBuffer.size() >= until.length()) {
+            searchFrom = this->m_readBuffer.size() - until.length() + 1;
         }
-        returnArray += maybeChar;
-        if (returnArray.endsWith(until)) {
-            return returnArray.subsequence(0, returnArray.length() - until.length());
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
         }
-    } while ( (IByteStream::getEpoch() - startTime) <= this->m_readTimeout);
+        this->fillReadBuffer(deadline);
+    }
     if (timeout) {
         *timeout = true;
     }
-    return returnArray;
+    return this->m_readBuffer.read(this->m_readBuffer.size());
 }
 
 ByteArray IByteStream::readUntil(char until, bool *timeout) {
@@ -182,8 +407,9 @@ uint64_t IByteStream::getEpoch() {
 
  */
 
+//Monotonic, so elapsed time measured with it is immune to the wall clock being stepped
 int64_t IByteStream::getEpoch() {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 
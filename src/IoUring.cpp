@@ -0,0 +1,217 @@
+#include <CppSerialPort/IoUring.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using ErrorInformation::getLastError;
+using ErrorInformation::getErrorString;
+
+namespace CppSerialPort {
+
+const uint64_t IoUring::TIMEOUT_USER_DATA{~static_cast<uint64_t>(0)};
+
+IoUring::IoUring(unsigned entries, unsigned flags) :
+    m_ringDescriptor{-1},
+    m_parameters{},
+    m_submissionRing{MAP_FAILED},
+    m_submissionRingSize{0},
+    m_completionRing{MAP_FAILED},
+    m_completionRingSize{0},
+    m_submissionEntries{static_cast<io_uring_sqe *>(MAP_FAILED)},
+    m_submissionEntriesSize{0},
+    m_submissionHead{nullptr},
+    m_submissionTail{nullptr},
+    m_submissionMask{nullptr},
+    m_submissionArray{nullptr},
+    m_completionHead{nullptr},
+    m_completionTail{nullptr},
+    m_completionMask{nullptr},
+    m_completions{nullptr},
+    m_queuedTail{0},
+    m_timeout{}
+{
+    memset(&this->m_parameters, 0, sizeof(this->m_parameters));
+    this->m_parameters.flags = flags;
+    this->m_ringDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, entries, &this->m_parameters));
+    if (this->m_ringDescriptor == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::IoUring::IoUring(unsigned, unsigned): io_uring_setup(unsigned, io_uring_params *) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+
+    const auto &sqOffsets = this->m_parameters.sq_off;
+    const auto &cqOffsets = this->m_parameters.cq_off;
+    this->m_submissionRingSize = sqOffsets.array + this->m_parameters.sq_entries * sizeof(unsigned);
+    this->m_completionRingSize = cqOffsets.cqes + this->m_parameters.cq_entries * sizeof(io_uring_cqe);
+    auto singleMap = ( (this->m_parameters.features & IORING_FEAT_SINGLE_MMAP) != 0 );
+    if (singleMap) {
+        this->m_submissionRingSize = std::max(this->m_submissionRingSize, this->m_completionRingSize);
+    }
+    this->m_submissionRing = mmap(nullptr, this->m_submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->m_ringDescriptor, IORING_OFF_SQ_RING);
+    if (singleMap) {
+        this->m_completionRing = this->m_submissionRing;
+    } else if (this->m_submissionRing != MAP_FAILED) {
+        this->m_completionRing = mmap(nullptr, this->m_completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->m_ringDescriptor, IORING_OFF_CQ_RING);
+    }
+    this->m_submissionEntriesSize = this->m_parameters.sq_entries * sizeof(io_uring_sqe);
+    if (this->m_completionRing != MAP_FAILED) {
+        this->m_submissionEntries = static_cast<io_uring_sqe *>(mmap(nullptr, this->m_submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->m_ringDescriptor, IORING_OFF_SQES));
+    }
+    if (this->m_submissionEntries == MAP_FAILED) {
+        auto errorCode = getLastError();
+        this->unmap();
+        close(this->m_ringDescriptor);
+        throw std::runtime_error("CppSerialPort::IoUring::IoUring(unsigned, unsigned): mmap(void *, size_t, int, int, int, off_t) of the rings failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+
+    auto submissionRing = static_cast<char *>(this->m_submissionRing);
+    this->m_submissionHead = reinterpret_cast<unsigned *>(submissionRing + sqOffsets.head);
+    this->m_submissionTail = reinterpret_cast<unsigned *>(submissionRing + sqOffsets.tail);
+    this->m_submissionMask = reinterpret_cast<unsigned *>(submissionRing + sqOffsets.ring_mask);
+    this->m_submissionArray = reinterpret_cast<unsigned *>(submissionRing + sqOffsets.array);
+    auto completionRing = static_cast<char *>(this->m_completionRing);
+    this->m_completionHead = reinterpret_cast<unsigned *>(completionRing + cqOffsets.head);
+    this->m_completionTail = reinterpret_cast<unsigned *>(completionRing + cqOffsets.tail);
+    this->m_completionMask = reinterpret_cast<unsigned *>(completionRing + cqOffsets.ring_mask);
+    this->m_completions = reinterpret_cast<io_uring_cqe *>(completionRing + cqOffsets.cqes);
+    this->m_queuedTail = *this->m_submissionTail;
+}
+
+IoUring::~IoUring() {
+    this->unmap();
+    close(this->m_ringDescriptor);
+}
+
+void IoUring::unmap() {
+    if (this->m_submissionEntries != MAP_FAILED) {
+        munmap(this->m_submissionEntries, this->m_submissionEntriesSize);
+    }
+    if ( (this->m_completionRing != MAP_FAILED) && (this->m_completionRing != this->m_submissionRing) ) {
+        munmap(this->m_completionRing, this->m_completionRingSize);
+    }
+    if (this->m_submissionRing != MAP_FAILED) {
+        munmap(this->m_submissionRing, this->m_submissionRingSize);
+    }
+}
+
+bool IoUring::isSupported() {
+    static const bool supported{[]() {
+        io_uring_params parameters{};
+        memset(&parameters, 0, sizeof(parameters));
+        auto ringDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, 2, &parameters));
+        if (ringDescriptor == -1) {
+            return false;
+        }
+        close(ringDescriptor);
+        return true;
+    }()};
+    return supported;
+}
+
+io_uring_sqe *IoUring::nextSubmission() {
+    auto head = __atomic_load_n(this->m_submissionHead, __ATOMIC_ACQUIRE);
+    if (this->m_queuedTail - head >= this->m_parameters.sq_entries) {
+        return nullptr;
+    }
+    auto index = this->m_queuedTail & *this->m_submissionMask;
+    auto submission = &this->m_submissionEntries[index];
+    memset(submission, 0, sizeof(io_uring_sqe));
+    this->m_submissionArray[index] = index;
+    this->m_queuedTail++;
+    return submission;
+}
+
+unsigned IoUring::pendingSubmissions() const {
+    return this->m_queuedTail - *this->m_submissionTail;
+}
+
+unsigned IoUring::spaceLeft() const {
+    return this->m_parameters.sq_entries - (this->m_queuedTail - __atomic_load_n(this->m_submissionHead, __ATOMIC_ACQUIRE));
+}
+
+unsigned IoUring::submitAndWait(unsigned waitFor, int timeout) {
+    auto toSubmit = this->pendingSubmissions();
+    unsigned flags{0};
+    const void *argument{nullptr};
+    size_t argumentSize{0};
+    io_uring_getevents_arg eventsArgument{};
+    if ( (waitFor > 0) && (timeout >= 0) ) {
+        this->m_timeout.tv_sec = timeout / 1000;
+        this->m_timeout.tv_nsec = static_cast<long long>(timeout % 1000) * 1000000;
+        if (this->m_parameters.features & IORING_FEAT_EXT_ARG) {
+            memset(&eventsArgument, 0, sizeof(eventsArgument));
+            eventsArgument.ts = reinterpret_cast<uint64_t>(&this->m_timeout);
+            eventsArgument.sigmask_sz = _NSIG / 8;
+            flags |= IORING_ENTER_EXT_ARG;
+            argument = &eventsArgument;
+            argumentSize = sizeof(eventsArgument);
+        } else {
+            //Older kernels only take a timeout as a submission of its own
+            auto submission = this->nextSubmission();
+            if (submission != nullptr) {
+                submission->opcode = IORING_OP_TIMEOUT;
+                submission->fd = -1;
+                submission->addr = reinterpret_cast<uint64_t>(&this->m_timeout);
+                submission->len = 1;
+                submission->user_data = TIMEOUT_USER_DATA;
+                toSubmit++;
+            }
+        }
+    }
+    if (waitFor > 0) {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+    __atomic_store_n(this->m_submissionTail, this->m_queuedTail, __ATOMIC_RELEASE);
+    if ( (toSubmit == 0) && (waitFor == 0) ) {
+        return 0;
+    }
+    auto submitted = this->enter(toSubmit, waitFor, flags, argument, argumentSize);
+    if (submitted < 0) {
+        auto errorCode = -submitted;
+        //Timing out or being interrupted only means there is nothing to reap yet
+        if ( (errorCode == ETIME) || (errorCode == EINTR) || (errorCode == EAGAIN) || (errorCode == EBUSY) ) {
+            return 0;
+        }
+        throw std::runtime_error("CppSerialPort::IoUring::submitAndWait(unsigned, int): io_uring_enter(int, unsigned, unsigned, unsigned, const void *, size_t) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    return static_cast<unsigned>(submitted);
+}
+
+int IoUring::enter(unsigned toSubmit, unsigned waitFor, unsigned flags, const void *argument, size_t argumentSize) {
+    auto result = syscall(__NR_io_uring_enter, this->m_ringDescriptor, toSubmit, waitFor, flags, argument, argumentSize);
+    return (result == -1) ? -getLastError() : static_cast<int>(result);
+}
+
+void IoUring::registerBuffers(const iovec *buffers, unsigned count) {
+    if (syscall(__NR_io_uring_register, this->m_ringDescriptor, IORING_REGISTER_BUFFERS, buffers, count) == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::IoUring::registerBuffers(const iovec *, unsigned): io_uring_register(IORING_REGISTER_BUFFERS) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+}
+
+void IoUring::registerFiles(const int *fileDescriptors, unsigned count) {
+    if (syscall(__NR_io_uring_register, this->m_ringDescriptor, IORING_REGISTER_FILES, fileDescriptors, count) == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::IoUring::registerFiles(const int *, unsigned): io_uring_register(IORING_REGISTER_FILES) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+}
+
+void IoUring::updateFile(unsigned index, int fileDescriptor) {
+    io_uring_files_update update{};
+    memset(&update, 0, sizeof(update));
+    update.offset = index;
+    update.fds = reinterpret_cast<uint64_t>(&fileDescriptor);
+    if (syscall(__NR_io_uring_register, this->m_ringDescriptor, IORING_REGISTER_FILES_UPDATE, &update, 1) == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::IoUring::updateFile(unsigned, int): io_uring_register(IORING_REGISTER_FILES_UPDATE) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+}
+
+} //namespace CppSerialPort
@@ -1,837 +1,1390 @@
-#include <CppSerialPort/SerialPort.hpp>
-#include <CppSerialPort/ErrorInformation.hpp>
-
-#include <cstdio>
-#include <cstring>
-#include <utility>
-#include <stdexcept>
-#include <cctype>
-#include <algorithm>
-#include <set>
-#include <iostream>
-#include <limits>
-#include <climits>
-
-#if defined(_WIN32)
-#    include <io.h>
-#    include <fcntl.h>
-#    include <thread>
-#define INVALID_FILE_DESCRIPTOR NULL
-#else
-#   include <termios.h>
-#   include <unistd.h>
-#   include <sys/ioctl.h>
-#   include <fcntl.h>
-#   include <sys/types.h>
-#   include <sys/stat.h>
-#   include <climits>
-#   include <sys/file.h>
-#   include <cerrno>
-#   include <sys/signal.h>
-#define INVALID_FILE_DESCRIPTOR -1
-#endif //defined(_WIN32)
-
-
-using ErrorInformation::getLastError;
-using ErrorInformation::getErrorString;
-
-namespace CppSerialPort {
-
-const DataBits SerialPort::DEFAULT_DATA_BITS{DataBits::DataEight};
-const StopBits SerialPort::DEFAULT_STOP_BITS{StopBits::StopOne};
-const Parity SerialPort::DEFAULT_PARITY{Parity::ParityNone};
-const BaudRate SerialPort::DEFAULT_BAUD_RATE{BaudRate::Baud9600};
-const FlowControl SerialPort::DEFAULT_FLOW_CONTROL{FlowControl::FlowOff};
-
-#if defined(_WIN32)
-    const char *SerialPort::AVAILABLE_PORT_NAMES_BASE{R"(\\.\COM)"};
-    const char *SerialPort::SERIAL_PORT_REGISTRY_PATH{R"(HARDWARE\DEVICEMAP\SERIALCOMM\)"};
-    const std::string SerialPort::DEFAULT_LINE_ENDING{"\r\n"};
-#else
-    const std::vector<const char *> SerialPort::AVAILABLE_PORT_NAMES_BASE{"/dev/ttyS", "/dev/ttyACM", "/dev/ttyUSB",
-                                                                      "/dev/ttyAMA", "/dev/ttyrfcomm", "/dev/ircomm",
-                                                                      "/dev/cuau", "/dev/cuaU", "/dev/rfcomm"};
-const std::string SerialPort::DEFAULT_LINE_ENDING{"\n"};
-
-#endif
-
-const std::vector<std::string> SerialPort::SERIAL_PORT_NAMES{SerialPort::generateSerialPortNames()};
-
-SerialPort::SerialPort(const std::string &name, BaudRate baudRate, DataBits dataBits, StopBits stopBits, Parity parity, FlowControl flowControl, const std::string &lineEnding) :
-        m_portName{name},
-        m_portNumber{0},
-        m_baudRate{baudRate},
-        m_stopBits{stopBits},
-        m_dataBits{dataBits},
-        m_parity{parity},
-        m_flowControl{flowControl},
-        m_fileDescriptor{INVALID_FILE_DESCRIPTOR}
-{
-    this->setLineEnding(lineEnding);
-    std::pair<int, std::string> truePortNameAndNumber{getPortNameAndNumber(this->m_portName)};
-    this->m_portNumber = truePortNameAndNumber.first;
-    this->m_portName = truePortNameAndNumber.second;
-}
-
-
-file_descriptor_t SerialPort::getFileDescriptor() const {
-    return this->m_fileDescriptor;
-}
-
-
-void SerialPort::openPort() {
-    if (!isAvailableSerialPort(this->portName())) {
-        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): ERROR: " + this->portName() + " is not a currently available serial port (is something else using it?)");
-    }
-#if defined(_WIN32)
-    auto handle = CreateFileA(this->m_portName.c_str(), GENERIC_READ|GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
-    if(handle == INVALID_FILE_DESCRIPTOR) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): CreateFileA(LPCSTR, DWORD, DWORD, LPSECURITY_ATTRIBUTES, DWORD, DWORD, HANDLE, HANDLE): Unable to open serial port " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-
-    //Get full configuration
-    if (!GetCommConfig(handle, &this->m_portSettings, &this->m_portSettings.dwSize)) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): GetCommConfig(HANDLE, LPCOMMCONFIG, LPDWORD): Unable to get current communication configuration for  " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-
-    //Get DCB settings
-    if (!GetCommState(handle, &(this->m_portSettings.dcb))) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): GetCommState(HANDLE, LPDCB): Unable to get current communication state for  " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-
-    /*set up parameters*/
-    this->m_portSettings.dcb.fBinary=TRUE;
-    this->m_portSettings.dcb.fInX=FALSE;
-    this->m_portSettings.dcb.fOutX=FALSE;
-    this->m_portSettings.dcb.fAbortOnError=FALSE;
-    this->m_portSettings.dcb.fNull=FALSE;
-#else
-    auto fileHandle = ::open(this->portName().c_str(), O_RDWR);
-    if (fileHandle == INVALID_FILE_DESCRIPTOR) {
-        auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): ERROR: open(" + this->portName() + ") returned error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
-    }
-    this->m_fileDescriptor = fileHandle;
-    if (tcgetattr(this->getFileDescriptor(), &this->m_oldPortSettings) != 0) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): tcgetattr(int, termios *): Unable to get current attributes for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-    memset(&this->m_portSettings, 0, sizeof(this->m_portSettings));
-    this->m_portSettings = this->m_oldPortSettings;
-    cfmakeraw(&this->m_portSettings);
-
-    this->m_portSettings.c_lflag &= (~(ICANON|ECHO|ECHOE|ECHOK|ECHONL|ISIG));
-    this->m_portSettings.c_iflag &= (~(INPCK|IGNPAR|PARMRK|ISTRIP|ICRNL|IXANY));
-    this->m_portSettings.c_oflag &= (~OPOST);
-    this->m_portSettings.c_cc[VMIN]= 0;
-    this->m_portSettings.c_cflag |= (CLOCAL | CREAD);
-#endif
-
-    this->setBaudRate(this->m_baudRate);
-    this->setDataBits(this->m_dataBits);
-    this->setStopBits(this->m_stopBits);
-    this->setParity(this->m_parity);
-    this->setFlowControl(this->m_flowControl);
-    this->setReadTimeout(this->readTimeout());
-
-    this->enableDTR();
-    this->enableRTS();
-}
-
-void SerialPort::setReadTimeout(int timeout) {
-    IByteStream::setReadTimeout(timeout);
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    COMMTIMEOUTS commTimeouts{0, 0, 0, 0, 0};
-    commTimeouts.ReadIntervalTimeout         = MAXDWORD;
-    commTimeouts.ReadTotalTimeoutMultiplier  = 0;
-    commTimeouts.ReadTotalTimeoutConstant    = static_cast<DWORD>(this->readTimeout());
-    commTimeouts.WriteTotalTimeoutMultiplier = 0;
-    commTimeouts.WriteTotalTimeoutConstant   = static_cast<DWORD>(this->writeTimeout());
-
-    if(!SetCommTimeouts(this->m_fileDescriptor, &commTimeouts)) {
-        auto errorCode = getLastError();
-        this->closePort();
-        throw std::runtime_error("CppSerialPort::SerialPort::setReadTimeout(int timeout): SetCommTimeouts(HANDLE, COMMTIMEOUTS*): Unable to set timeout settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-#else
-    if (this->readTimeout() == 0) {
-    fcntl(this->getFileDescriptor(), F_SETFL, O_NDELAY);
-} else {
-    fcntl(this->getFileDescriptor(), F_SETFL, O_SYNC);
-    this->m_portSettings.c_cc[VTIME] = static_cast<cc_t>(this->readTimeout() / 100);
-    tcsetattr(this->getFileDescriptor(), TCSANOW, &this->m_portSettings);
-}
-#endif //defined(_WIN32)
-}
-
-char SerialPort::read(bool *readTimeout) {
-#if defined(_WIN32)
-    if (!this->m_readBuffer.empty()) {
-        char returnValue{this->m_readBuffer[0]};
-        this->m_readBuffer.popFront();
-        if (readTimeout) {
-            *readTimeout = false;
-        }
-        return returnValue;
-    }
-
-    static char readStuff[SERIAL_PORT_BUFFER_MAX];
-    memset(readStuff, '\0', SERIAL_PORT_BUFFER_MAX);
-    auto startTime = IByteStream::getEpoch();
-    do {
-        DWORD commErrors{};
-        COMSTAT commStatus{0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-        auto clearErrorsResult = ClearCommError(this->m_fileDescriptor, &commErrors, &commStatus);
-        if (clearErrorsResult == 0) {
-            const auto errorCode = getLastError();
-            throw std::runtime_error("ClearCommError(HANDLE, LPDWORD, LPCOMSTAT) error: " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ")");
-        }
-        DWORD maxBytes{commStatus.cbInQue};
-        if (maxBytes == 0) {
-            if (this->readTimeout() > 0) {
-                continue;
-            } else {
-                break;
-            }
-        }
-        DWORD returnedBytes{0};
-        auto result = ReadFile(this->m_fileDescriptor, &readStuff, maxBytes, &returnedBytes, nullptr);
-        if (result == 0) {
-            const auto errorCode = getLastError();
-            throw std::runtime_error("ReadFile(HANDLE, LPDWORD, DWORD, LPDWORD, LPOVERLAPPED) error: " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ")");
-        }
-
-        if (returnedBytes > 0) {
-            for (size_t i = 0; i < returnedBytes; i++) {
-                this->m_readBuffer += readStuff[i];
-            }
-            char returnValue{this->m_readBuffer[0]};
-            this->m_readBuffer.popFront();
-            if (readTimeout) {
-                *readTimeout = false;
-            }
-            return returnValue;
-        }
-    } while ( (this->readTimeout() < 0) ? true : ( (IByteStream::getEpoch() - startTime) < static_cast<unsigned long>(this->readTimeout()) ) );
-    if (readTimeout) {
-        *readTimeout = true;
-    }
-    return 0;
-
-#else
-    if (!this->m_readBuffer.empty()) {
-        char returnValue{this->m_readBuffer[0]};
-        this->m_readBuffer.popFront();
-        if (readTimeout) {
-            *readTimeout = false;
-        }
-        return returnValue;
-    }
-    if (this->isDisconnected()) {
-        this->closePort();
-        throw SerialPortDisconnectedException{this->m_portName, "CppSerialPort::SerialPort::read(): The serial port has been disconnected from the system"};
-    }
-
-    //Use select() to wait for data to arrive
-    //At socket, then read and return
-    fd_set read_fds{0, 0, 0};
-    fd_set write_fds{0, 0, 0};
-    fd_set except_fds{0, 0, 0};
-    FD_ZERO(&read_fds);
-    FD_ZERO(&write_fds);
-    FD_ZERO(&except_fds);
-    FD_SET(this->getFileDescriptor(), &read_fds);
-
-    struct timeval timeout{0, 0};
-    timeout.tv_sec = 0;
-    timeout.tv_usec = (this->readTimeout() * 1000);
-    static char readStuff[SERIAL_PORT_BUFFER_MAX];
-    memset(readStuff, '\0', SERIAL_PORT_BUFFER_MAX);
-
-    if (select(this->getFileDescriptor() + 1, &read_fds, &write_fds, &except_fds, &timeout) == 1) {
-        int bytesAvailable{0};
-        ioctl(this->getFileDescriptor(), FIONREAD, &bytesAvailable);
-        auto returnedBytes = ::read(this->getFileDescriptor(), readStuff, static_cast<size_t>(bytesAvailable));
-        if (returnedBytes <= 0) {
-            if (readTimeout) {
-                *readTimeout = true;
-            }
-            if (this->isDisconnected()) {
-                this->closePort();
-                throw SerialPortDisconnectedException{this->m_portName, "CppSerialPort::SerialPort::read(): The serial port has been disconnected from the system"};
-            }
-            return 0;
-        }
-        for (auto i = 0; i < returnedBytes; i++) {
-            this->m_readBuffer += readStuff[i];
-        }
-        char returnValue{this->m_readBuffer[0]};
-        this->m_readBuffer.popFront();
-        if (readTimeout) {
-            *readTimeout = false;
-        }
-        return returnValue;
-    }
-    if (readTimeout) {
-        *readTimeout = true;
-    }
-    return 0;
-#endif //defined(_WIN32)
-}
-
-bool SerialPort::isDisconnected() {
-    auto availablePorts = SerialPort::availableSerialPorts();
-    return (availablePorts.find(this->m_portName) == availablePorts.end());
-}
-
-ssize_t SerialPort::write(char c) {
-#if defined(_WIN32)
-    DWORD writtenBytes{};
-    auto result = WriteFile(this->getFileDescriptor(), &c, 1, &writtenBytes, nullptr);
-    if (result == 0) {
-        return (getLastError() == EAGAIN ? 0 : writtenBytes);
-    }
-#else
-    auto writtenBytes = ::write(this->getFileDescriptor(), &c, 1);
-#endif //defined(_WIN32)
-    if (writtenBytes != 1) {
-        return (getLastError() == EAGAIN ? 0 : writtenBytes);
-    }
-    return writtenBytes;
-}
-
-ssize_t SerialPort::write(const char *bytes, size_t numberOfBytes) {
-#if defined(_WIN32)
-    DWORD writtenBytes{};
-    auto result = WriteFile(this->getFileDescriptor(), bytes, numberOfBytes, &writtenBytes, nullptr);
-    if (result == 0) {
-        return (getLastError() == EAGAIN ? 0 : writtenBytes);
-    }
-#else
-    auto writtenBytes = ::write(this->m_fileDescriptor, bytes, numberOfBytes);
-#endif //defined(_WIN32)
-    if (writtenBytes != static_cast<long>(numberOfBytes)) {
-        return (getLastError() == EAGAIN ? 0 : writtenBytes);
-    }
-    return writtenBytes;
-}
-
-void SerialPort::closePort() {
-    if (!this->isOpen()) {
-        return;
-    }
-    try {
-#if defined(_WIN32)
-    CancelIo(this->m_fileDescriptor);
-    CloseHandle(this->m_fileDescriptor);
-#else
-        //TODO: Check error codes for these functions
-    std::memcpy(&this->m_portSettings, &this->m_oldPortSettings, sizeof(this->m_portSettings));
-    this->m_portSettings = this->m_oldPortSettings;
-    this->applyPortSettings();
-    auto result = ::close(this->m_fileDescriptor);
-        (void)result;
-#endif
-    } catch (const std::exception &e) {
-        std::cerr << "CppSerialPort::SerialPort::closePort(): Exception caught: \"" << e.what() << "\"" << std::endl;
-    }
-    this->m_fileDescriptor = INVALID_FILE_DESCRIPTOR;
-}
-
-modem_status_t SerialPort::getModemStatus() const {
-#if defined(_WIN32)
-    modem_status_t status{0};
-    if (GetCommModemStatus(this->m_fileDescriptor, &status) == 0) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::getModemStatus(): GetCommModemStatus(HANDLE, LPDWORD): Unable to get modem status for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-    return status;
-#else
-    modem_status_t status{0};
-if(ioctl(this->getFileDescriptor(), TIOCMGET, &status) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::getModemStatus(): ioctl(int, int, int): Unable to get modem settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-#endif //defined(_WIN32)
-    return status;
-}
-
-void SerialPort::enableDTR() {
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    if (EscapeCommFunction(this->m_fileDescriptor, SETDTR) == 0) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::enableDTR(): EscapeCommFunction(HANDLE, DWORD): Unable to set DTR settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-#else
-    modem_status_t status{this->getModemStatus()};
-status |= TIOCM_DTR;
-if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::enableDTR(): ioctl(int, int, int): Unable to set DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-#endif
-}
-
-void SerialPort::disableDTR() {
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    if (EscapeCommFunction(this->m_fileDescriptor, CLRDTR) == 0) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::disableDTR(): EscapeCommFunction(HANDLE, DWORD): Unable to reset DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-#else
-    modem_status_t status{this->getModemStatus()};
-status &= ~TIOCM_DTR;
-if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::disableDTR(): ioctl(int, int, int): Unable to reset DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-#endif
-}
-
-void SerialPort::enableRTS() {
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    if (EscapeCommFunction(this->m_fileDescriptor, SETRTS) == 0) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::enableRTS(): EscapeCommFunction(HANDLE, DWORD): Unable to set RTS for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-#else
-    modem_status_t status{this->getModemStatus()};
-status |= TIOCM_RTS;
-if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::enableRTS(): ioctl(int, int, int): Unable to set RTS for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-#endif
-}
-
-void SerialPort::disableRTS() {
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    if (EscapeCommFunction(this->m_fileDescriptor, CLRRTS) == 0) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::disableRTS(): EscapeCommFunction(HANDLE, DWORD): Unable to reset RTS for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-#else
-    modem_status_t status{this->getModemStatus()};
-status &= ~TIOCM_RTS;
-if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::disableRTS(): ioctl(int, int, int): Unable to reset DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-#endif
-}
-
-bool SerialPort::isDCDEnabled() const {
-    if (!this->isOpen()) {
-        return false;
-    }
-#if defined(_WIN32)
-    return static_cast<bool>(this->getModemStatus() & MS_RLSD_ON);
-#else
-    return static_cast<bool>(this->getModemStatus() & TIOCM_CAR);
-#endif
-}
-
-
-bool SerialPort::isCTSEnabled() const {
-    if (!this->isOpen()) {
-        return false;
-    }
-#if defined(_WIN32)
-    return static_cast<bool>(this->getModemStatus() & MS_CTS_ON);
-#else
-    return static_cast<bool>(this->getModemStatus() & TIOCM_CTS);
-#endif
-}
-
-bool SerialPort::isDSREnabled() const {
-    if (!this->isOpen()) {
-        return false;
-    }
-#if defined(_WIN32)
-    return static_cast<bool>(this->getModemStatus() & MS_DSR_ON);
-#else
-    return static_cast<bool>(this->getModemStatus() & TIOCM_DSR);
-#endif
-}
-
-void SerialPort::flushRx() {
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    PurgeComm(this->m_fileDescriptor, PURGE_RXCLEAR | PURGE_RXABORT);
-#else
-    tcflush(this->getFileDescriptor(), TCIFLUSH);
-#endif
-}
-
-
-void SerialPort::flushTx() {
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    PurgeComm(this->m_fileDescriptor, PURGE_TXCLEAR | PURGE_TXABORT);
-#else
-    tcflush(this->getFileDescriptor(), TCOFLUSH);
-#endif
-}
-
-
-bool SerialPort::isAvailableSerialPort(const std::string &name) {
-    auto availablePorts = availableSerialPorts();
-#if defined(_WIN32)
-    std::string copyName{name};
-    copyName.erase(std::remove_if(copyName.begin(), copyName.end(), [](char c) { return ( (c == '.') || (c == '\\') ); }), copyName.end());
-    return (availablePorts.find(copyName) != availablePorts.end());
-#else
-    return (availablePorts.find(name) != availablePorts.end());
-#endif //defined(_WIN32)
-}
-
-bool SerialPort::isOpen() const {
-    return (this->m_fileDescriptor != INVALID_FILE_DESCRIPTOR);
-}
-
-
-void SerialPort::setDataBits(DataBits dataBits) {
-    if ( (this->m_stopBits == StopBits::StopTwo) && (dataBits == DataBits::DataFive) ) {
-        throw std::runtime_error("CppSerialPort::SerialPort::setDataBits(DataBits): Five data bits cannot be used with two stop bits");
-    }
-#if defined(_WIN32)
-    if ( (dataBits != DataBits::DataFive) && (this->m_stopBits == StopBits::StopOneFive) ) {
-        throw std::runtime_error("CppSerialPort::SerialPort::setDataBits(DataBits): 1.5 stop bits can only be used with 5 data bits");
-    }
-    this->m_portSettings.dcb.ByteSize = static_cast<BYTE>(dataBits);
-#else
-    this->m_portSettings.c_cflag &= (~CSIZE);
-this->m_portSettings.c_cflag |= static_cast<tcflag_t>(dataBits);
-#endif //defined(_WIN32)
-
-    this->applyPortSettings();
-    this->m_dataBits = dataBits;
-}
-
-void SerialPort::setBaudRate(BaudRate baudRate) {
-#if defined(_WIN32)
-    this->m_portSettings.dcb.BaudRate = static_cast<DWORD>(baudRate);
-#else
-    if (cfsetispeed(&this->m_portSettings, static_cast<speed_t>(baudRate)) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::setBaudRate(BaudRate): cfsetispeed(port_settings_t *, speed_t): Unable to set baud rate settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-if (cfsetospeed(&this->m_portSettings, static_cast<speed_t>(baudRate)) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::setBaudRate(BaudRate): cfsetospeed(port_settings_t *, speed_t): Unable to set baud rate settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-/*
-this->m_portSettings.c_cflag &= ~(CBAUD);
-this->m_portSettings.c_cflag |= static_cast<speed_t>(baudRate);
-*/
-#endif //defined(_WIN32)
-    this->applyPortSettings();
-    this->m_baudRate = baudRate;
-}
-
-void SerialPort::setStopBits(StopBits stopBits) {
-    if ( (stopBits == StopBits::StopTwo) && (this->m_dataBits == DataBits::DataFive) ) {
-        throw std::runtime_error("CppSerialPort::SerialPort::setStopBits(StopBits): 2 stop bits can not be used with 5 data bits");
-    }
-#if defined(_WIN32)
-    if ( (stopBits == StopBits::StopOneFive) && (this->m_dataBits != DataBits::DataFive) ) {
-        throw std::runtime_error("CppSerialPort::SerialPort::setStopBits(StopBits): 1.5 stop bits can only be used with 5 data bits");
-    }
-    this->m_portSettings.dcb.StopBits = static_cast<BYTE>(stopBits);
-#else
-    if (stopBits == StopBits::StopOne) {
-    this->m_portSettings.c_cflag &= (~CSTOPB);
-} else if (stopBits == StopBits::StopTwo){
-    this->m_portSettings.c_cflag |= CSTOPB;
-}
-#endif //defined(_WIN32)
-    this->applyPortSettings();
-    this->m_stopBits = stopBits;
-}
-
-void SerialPort::setParity(Parity parity) {
-#if defined(_WIN32)
-    if (parity == Parity::ParityNone) {
-        this->m_portSettings.dcb.fParity = FALSE;
-    } else if (parity == Parity::ParityEven) {
-        this->m_portSettings.dcb.fParity = TRUE;
-    } else if (parity == Parity::ParityOdd) {
-        this->m_portSettings.dcb.fParity = TRUE;
-    } else if (parity == Parity::ParityMark) {
-        this->m_portSettings.dcb.fParity = TRUE;
-    } else if (parity == Parity::ParitySpace) {
-        this->m_portSettings.dcb.fParity = TRUE;
-    }
-    this->m_portSettings.dcb.Parity = static_cast<unsigned char>(parity);
-#else
-    if ( (parity == Parity::ParitySpace) && (this->m_dataBits == DataBits::DataEight) ) {
-    throw std::runtime_error("CppSerialPort::SerialPort::setParity(Parity): Eight data bits cannot be used with space parity");
-}
-if (parity == Parity::ParityNone) {
-    this->m_portSettings.c_cflag &= (~PARENB);
-    this->m_portSettings.c_iflag &= (~INPCK);
-    this->m_portSettings.c_iflag |= IGNPAR;
-} else if (parity == Parity::ParityEven) {
-    this->m_portSettings.c_cflag |= PARENB;
-    this->m_portSettings.c_iflag |= INPCK; //Set parity
-    this->m_portSettings.c_iflag &= (~IGNPAR); //Reset ignore parity
-} else if (parity == Parity::ParityOdd) {
-    this->m_portSettings.c_cflag |= (PARENB | PARODD);
-    this->m_portSettings.c_iflag |= INPCK; //Set parity
-    this->m_portSettings.c_iflag &= (~IGNPAR); //Reset ignore parity
-} else if (parity == Parity::ParitySpace) {
-    //Simulate space by adding extra data bit
-    this->setDataBits(static_cast<DataBits>(static_cast<int>(this->m_dataBits) + 1));
-}
-#endif //defined(_WIN32)
-    this->applyPortSettings();
-    this->m_parity = parity;
-}
-
-void SerialPort::setFlowControl(FlowControl flowControl) {
-#if defined(_WIN32)
-    if (flowControl == FlowControl::FlowOff) {
-        this->m_portSettings.dcb.fOutxCtsFlow = FALSE;
-        this->m_portSettings.dcb.fRtsControl = RTS_CONTROL_DISABLE;
-        this->m_portSettings.dcb.fInX = FALSE;
-        this->m_portSettings.dcb.fOutX = FALSE;
-    } else if (flowControl == FlowControl::FlowXonXoff) {
-        this->m_portSettings.dcb.fOutxCtsFlow = FALSE;
-        this->m_portSettings.dcb.fRtsControl = RTS_CONTROL_DISABLE;
-        this->m_portSettings.dcb.fInX = TRUE;
-        this->m_portSettings.dcb.fOutX = TRUE;
-    } else if (flowControl == FlowControl::FlowHardware) {
-        this->m_portSettings.dcb.fOutxCtsFlow = TRUE;
-        this->m_portSettings.dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
-        this->m_portSettings.dcb.fInX = FALSE;
-        this->m_portSettings.dcb.fOutX = FALSE;
-    }
-#else
-    if (flowControl == FlowControl::FlowOff) {
-    this->m_portSettings.c_cflag &= (~CRTSCTS);
-    this->m_portSettings.c_iflag &= (~(IXON | IXOFF | IXANY));
-} else if (flowControl == FlowControl::FlowXonXoff) {
-    this->m_portSettings.c_cflag &= (~CRTSCTS);
-    this->m_portSettings.c_iflag |= (IXON|IXOFF|IXANY);
-} else if (flowControl == FlowControl::FlowHardware) {
-    this->m_portSettings.c_cflag |= CRTSCTS;
-    this->m_portSettings.c_iflag &= (~(IXON|IXOFF|IXANY));
-}
-#endif //defined(_WIN32)
-    this->applyPortSettings();
-    this->m_flowControl = flowControl;
-}
-
-void SerialPort::applyPortSettings() {
-    if (!this->isOpen()) {
-        return;
-    }
-#if defined(_WIN32)
-    if (SetCommConfig(this->m_fileDescriptor, &this->m_portSettings, sizeof(COMMCONFIG)) == 0) {
-        const auto errorCode = getLastError();
-        throw std::runtime_error("CppSerialPort::SerialPort::applyPortSettings(): SetCommConfig(HANDLE, COMMCONFIG, DWORD): Unable to apply serial port attributes for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-    }
-#else
-    if (tcsetattr(this->getFileDescriptor(), TCSANOW, &this->m_portSettings) == -1) {
-    const auto errorCode = getLastError();
-    throw std::runtime_error("CppSerialPort::SerialPort::applyPortSettings(): tcsetattr(int, int, termios *): Unable to apply serial port attributes for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
-}
-#endif //defined(_WIN32)
-}
-
-
-BaudRate SerialPort::baudRate() const {
-    return this->m_baudRate;
-}
-
-StopBits SerialPort::stopBits() const {
-    return this->m_stopBits;
-}
-
-DataBits SerialPort::dataBits() const {
-    return this->m_dataBits;
-}
-
-Parity SerialPort::parity() const {
-    return this->m_parity;
-}
-
-FlowControl SerialPort::flowControl() const {
-    return this->m_flowControl;
-}
-
-std::string SerialPort::portName() const {
-#if defined(_WIN32)
-    std::string copyName{this->m_portName};
-    copyName.erase(std::remove_if(copyName.begin(), copyName.end(), [](char c) { return ( (c == '.') || (c == '\\') ); }), copyName.end());
-    return copyName;
-#else
-    return this->m_portName;
-#endif //defined(_WIN32)
-}
-
-std::unordered_set<std::string> SerialPort::availableSerialPorts() {
-    std::unordered_set<std::string> returnSet;
-#if defined(_WIN32)
-    try {
-        HKEY hRegistryKey;
-        LONG operationResult{ RegOpenKeyExA(HKEY_LOCAL_MACHINE, SERIAL_PORT_REGISTRY_PATH, 0, KEY_READ|KEY_WOW64_64KEY, &hRegistryKey) };
-        if (operationResult != ERROR_SUCCESS) {
-            return returnSet;
-        }
-        for (DWORD index = 0; ; index++) {
-            char subKeyName[PATH_MAX];
-            DWORD cbName{ PATH_MAX };
-            operationResult = RegEnumValueA(hRegistryKey, index, subKeyName, &cbName, nullptr, nullptr, nullptr, nullptr);
-            if (operationResult != ERROR_SUCCESS) {
-                break;
-            }
-            BYTE hRegistryKeyByteValue[PATH_MAX];
-            DWORD cbType{};
-            DWORD cbData{ PATH_MAX };
-            operationResult = RegQueryValueExA(hRegistryKey, subKeyName, nullptr, &cbType, hRegistryKeyByteValue, &cbData);
-            if (operationResult != ERROR_SUCCESS) {
-                std::cerr << "CppSerialPort::SerialPort::availableSerialPorts(): RegQueryValueExA returned " << operationResult << " (" << getErrorString(operationResult) << ")" << std::endl;
-                break;
-            }
-            if ( (cbType == REG_SZ) || (cbType == REG_MULTI_SZ) || (REG_EXPAND_SZ) ) {
-                hRegistryKeyByteValue[cbData] = '\0';
-            }
-            std::string tempString{""};
-            for (unsigned int i = 0; i < cbData - 1; i++) {
-                tempString += *reinterpret_cast<char *>(&(hRegistryKeyByteValue[i]));
-            }
-            returnSet.emplace(tempString);
-        }
-        RegCloseKey(hRegistryKey);
-        return returnSet;
-    } catch (std::exception &e) {
-        (void)e;
-        return returnSet;
-    }
-#else
-    for (auto &it : SerialPort::SERIAL_PORT_NAMES) {
-    if (IByteStream::fileExists(std::string{it})) {
-        returnSet.emplace(it);
-    }
-}
-return returnSet;
-#endif
-}
-
-std::vector<std::string> SerialPort::generateSerialPortNames() {
-    std::vector<std::string> returnSet;
-#if defined(_WIN32)
-    for (int i = 0; i < UCHAR_MAX; i++) {
-        returnSet.push_back(AVAILABLE_PORT_NAMES_BASE + toStdString(i));
-    }
-#else
-    for (auto &it : SerialPort::AVAILABLE_PORT_NAMES_BASE) {
-    for (int i = 0; i < UCHAR_MAX; i++) {
-        returnSet.push_back(it + toStdString(i));
-    }
-}
-#endif //defined(_WIN32)
-    return returnSet;
-}
-
-bool SerialPort::isValidSerialPortName(const std::string &serialPortName) {
-#if defined(_WIN32)
-    auto foundCom = serialPortName.find("COM");
-    if ( (foundCom == std::string::npos) || (foundCom != 0) || (serialPortName.length() == 3)) {
-        return false;
-    }
-    try {
-        int comNumber{ std::stoi(serialPortName.substr(strlen("COM"))) };
-        return ((comNumber > 0) && (comNumber < UCHAR_MAX));
-    } catch (std::exception &e) {
-        (void)e;
-        return false;
-    }
-#else
-    for (auto &it : SerialPort::AVAILABLE_PORT_NAMES_BASE) {
-    for (int i = 0; i < UCHAR_MAX; i++) {
-        if (serialPortName == (it + toStdString(i))) {
-            return true;
-        }
-    }
-}
-return false;
-#endif
-}
-
-std::pair<int, std::string> SerialPort::getPortNameAndNumber(const std::string &name) {
-#if defined(_WIN32)
-    auto foundCom = name.find("COM");
-    if ((foundCom != 0) || (name.length() == 3)) {
-        throw std::runtime_error("CppSerialPort::SerialPort::getPortNameAndNumber(const std::string &): ERROR: " + name + " is an invalid serial port name");
-    }
-    try {
-        int comNumber{ std::stoi(name.substr(3)) };
-        return std::make_pair(comNumber, AVAILABLE_PORT_NAMES_BASE + toStdString(comNumber));
-    } catch (std::exception &e) {
-        (void)e;
-        throw std::runtime_error("CppSerialPort::SerialPort::getPortNameAndNumber(const std::string &): ERROR: " + name + " is an invalid serial port name");
-    }
-#else
-    std::string str{name};
-auto iter = std::find(SERIAL_PORT_NAMES.cbegin(), SERIAL_PORT_NAMES.cend(), str);
-if (iter != SERIAL_PORT_NAMES.cend()) {
-    return std::make_pair(static_cast<int>(std::distance(SERIAL_PORT_NAMES.begin(), iter)), str);
-}
-str = name;
-if (str.find("/dev/tty") == std::string::npos) {
-    str = "/dev/tty" + str;
-}
-iter = std::find(SERIAL_PORT_NAMES.cbegin(), SERIAL_PORT_NAMES.cend(), str);
-if (iter != SERIAL_PORT_NAMES.cend()) {
-    return std::make_pair(static_cast<int>(std::distance(SERIAL_PORT_NAMES.begin(), iter)), str);
-}
-str = name;
-if (str.find("/dev/") == std::string::npos) {
-    str = "/dev/" + str;
-}
-iter = std::find(SERIAL_PORT_NAMES.cbegin(), SERIAL_PORT_NAMES.cend(), str);
-if (iter != SERIAL_PORT_NAMES.cend()) {
-    return std::make_pair(static_cast<int>(std::distance(SERIAL_PORT_NAMES.begin(), iter)), str);
-}
-
-throw std::runtime_error("CppSerialPort::SerialPort::getPortNameAndNumber(const std::string &): ERROR: " + name + " is an invalid serial port name");
-#endif
-}
-
-
-size_t SerialPort::available() {
-    return this->m_readBuffer.size();
-}
-
-SerialPort::~SerialPort() {
-    this->closePort();
-}
-
-
-}
-
-//namespace CppSerialPort
+#include <CppSerialPort/SerialPort.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+#include <CppSerialPort/DescriptorWaiter.hpp>
+#include <CppSerialPort/SpscByteQueue.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <cctype>
+#include <algorithm>
+#include <set>
+#include <iostream>
+#include <limits>
+#include <climits>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+#    include <io.h>
+#    include <fcntl.h>
+#    include <thread>
+#define INVALID_FILE_DESCRIPTOR NULL
+#else
+#   include <termios.h>
+#   include <unistd.h>
+#   include <sys/ioctl.h>
+#   include <fcntl.h>
+#   include <sys/types.h>
+#   include <sys/stat.h>
+#   include <climits>
+#   include <sys/file.h>
+#   include <sys/uio.h>
+#   include <cerrno>
+#   include <sys/signal.h>
+#   include <poll.h>
+#   include <dirent.h>
+#define INVALID_FILE_DESCRIPTOR -1
+#endif //defined(_WIN32)
+
+#if defined(__linux__)
+#    include <CppSerialPort/Termios2.hpp>
+#elif defined(__APPLE__)
+#    include <IOKit/serial/ioss.h>
+#endif //defined(__linux__)
+
+
+using ErrorInformation::getLastError;
+using ErrorInformation::getErrorString;
+
+namespace CppSerialPort {
+
+namespace {
+#if !defined(_WIN32)
+    const std::pair<BaudRate, uint32_t> STANDARD_BAUD_RATES[]{
+        {BaudRate::Baud50, 50}, {BaudRate::Baud75, 75}, {BaudRate::Baud110, 110}, {BaudRate::Baud134, 134},
+        {BaudRate::Baud150, 150}, {BaudRate::Baud200, 200}, {BaudRate::Baud300, 300}, {BaudRate::Baud600, 600},
+        {BaudRate::Baud1200, 1200}, {BaudRate::Baud1800, 1800}, {BaudRate::Baud2400, 2400}, {BaudRate::Baud4800, 4800},
+        {BaudRate::Baud9600, 9600}, {BaudRate::Baud19200, 19200}, {BaudRate::Baud38400, 38400}, {BaudRate::Baud57600, 57600},
+        {BaudRate::Baud115200, 115200}, {BaudRate::Baud230400, 230400}, {BaudRate::Baud460800, 460800}, {BaudRate::Baud500000, 500000},
+        {BaudRate::Baud576000, 576000}, {BaudRate::Baud921600, 921600}, {BaudRate::Baud1000000, 1000000}, {BaudRate::Baud1152000, 1152000},
+        {BaudRate::Baud1500000, 1500000}, {BaudRate::Baud2000000, 2000000}, {BaudRate::Baud2500000, 2500000}, {BaudRate::Baud3000000, 3000000},
+        {BaudRate::Baud3500000, 3500000}, {BaudRate::Baud4000000, 4000000}
+    };
+#endif //!defined(_WIN32)
+
+    bool toStandardBaudRate(uint32_t baudRateValue, BaudRate *baudRate) {
+#if defined(_WIN32)
+        //The enumerators are the plain numbers here, and the driver takes any other number as well
+        *baudRate = static_cast<BaudRate>(baudRateValue);
+        return true;
+#else
+        for (const auto &it : STANDARD_BAUD_RATES) {
+            if (it.second == baudRateValue) {
+                *baudRate = it.first;
+                return true;
+            }
+        }
+        return false;
+#endif //defined(_WIN32)
+    }
+
+    struct SerialPortInfoCache {
+        std::mutex mutex{};
+        bool populated{false};
+        uint64_t generation{0};
+        std::vector<SerialPortInfo> serialPortInfo{};
+#if defined(__linux__)
+        timespec devModified{0, 0};
+#endif //defined(__linux__)
+    };
+
+    SerialPortInfoCache &serialPortInfoCache() {
+        static SerialPortInfoCache cache{};
+        return cache;
+    }
+
+    SerialPortInfo makeSerialPortInfo(const std::string &name) {
+        return SerialPortInfo{name, "", 0, 0, "", "", ""};
+    }
+
+#if defined(__linux__)
+    const char *SYSFS_TTY_CLASS_PATH{"/sys/class/tty/"};
+
+    bool pathExists(const std::string &path) {
+        return access(path.c_str(), F_OK) != -1;
+    }
+
+    std::string readSysfsAttribute(const std::string &path) {
+        std::ifstream attributeFile{path};
+        std::string attribute{""};
+        std::getline(attributeFile, attribute);
+        while ( (!attribute.empty()) && (isspace(attribute.back())) ) {
+            attribute.pop_back();
+        }
+        return attribute;
+    }
+
+    std::string readSysfsLink(const std::string &path) {
+        char linkTarget[PATH_MAX];
+        auto linkLength = readlink(path.c_str(), linkTarget, sizeof(linkTarget) - 1);
+        if (linkLength <= 0) {
+            return "";
+        }
+        return std::string{linkTarget, static_cast<size_t>(linkLength)};
+    }
+
+    uint16_t readSysfsHexAttribute(const std::string &path) {
+        try {
+            return static_cast<uint16_t>(std::stoul(readSysfsAttribute(path), nullptr, 16));
+        } catch (const std::exception &e) {
+            (void)e;
+            return 0;
+        }
+    }
+
+    bool readSysfsSerialPortInfo(const std::string &ttyName, SerialPortInfo *serialPortInfo) {
+        const std::string ttyPath{SYSFS_TTY_CLASS_PATH + ttyName};
+        char devicePath[PATH_MAX];
+        if (realpath((ttyPath + "/device").c_str(), devicePath) == nullptr) {
+            return false;
+        }
+        //serial8250 registers every legacy port it might have, but only detected UARTs get a port type
+        if (readSysfsAttribute(ttyPath + "/type") == "0") {
+            return false;
+        }
+        //Walk up the device tree: the first driver outside the serial core is the real one,
+        //and the first ancestor with an idVendor is the USB device the port belongs to
+        for (std::string path{devicePath}; path.length() > strlen("/sys/devices"); path = path.substr(0, path.rfind('/'))) {
+            if (serialPortInfo->driver.empty()) {
+                auto driverLink = readSysfsLink(path + "/driver");
+                if ( (!driverLink.empty()) && (driverLink.find("/serial-base/") == std::string::npos) ) {
+                    serialPortInfo->driver = driverLink.substr(driverLink.rfind('/') + 1);
+                }
+            }
+            if (pathExists(path + "/idVendor")) {
+                serialPortInfo->vendorId = readSysfsHexAttribute(path + "/idVendor");
+                serialPortInfo->productId = readSysfsHexAttribute(path + "/idProduct");
+                serialPortInfo->manufacturer = readSysfsAttribute(path + "/manufacturer");
+                serialPortInfo->product = readSysfsAttribute(path + "/product");
+                serialPortInfo->serialNumber = readSysfsAttribute(path + "/serial");
+                break;
+            }
+        }
+        return true;
+    }
+#endif //defined(__linux__)
+}
+
+const DataBits SerialPort::DEFAULT_DATA_BITS{DataBits::DataEight};
+const StopBits SerialPort::DEFAULT_STOP_BITS{StopBits::StopOne};
+const Parity SerialPort::DEFAULT_PARITY{Parity::ParityNone};
+const BaudRate SerialPort::DEFAULT_BAUD_RATE{BaudRate::Baud9600};
+const FlowControl SerialPort::DEFAULT_FLOW_CONTROL{FlowControl::FlowOff};
+
+#if defined(_WIN32)
+    const char *SerialPort::AVAILABLE_PORT_NAMES_BASE{R"(\\.\COM)"};
+    const char *SerialPort::SERIAL_PORT_REGISTRY_PATH{R"(HARDWARE\DEVICEMAP\SERIALCOMM\)"};
+    const std::string SerialPort::DEFAULT_LINE_ENDING{"\r\n"};
+#else
+    const std::vector<const char *> SerialPort::AVAILABLE_PORT_NAMES_BASE{"/dev/ttyS", "/dev/ttyACM", "/dev/ttyUSB",
+                                                                      "/dev/ttyAMA", "/dev/ttyrfcomm", "/dev/ircomm",
+                                                                      "/dev/cuau", "/dev/cuaU", "/dev/rfcomm"};
+const std::string SerialPort::DEFAULT_LINE_ENDING{"\n"};
+const size_t SerialPort::DEFAULT_BACKGROUND_READER_CAPACITY{1024*1024};
+
+#endif
+
+const std::vector<std::string> SerialPort::SERIAL_PORT_NAMES{SerialPort::generateSerialPortNames()};
+
+SerialPortSettings::SerialPortSettings() :
+    SerialPortSettings{SerialPort::DEFAULT_BAUD_RATE, SerialPort::DEFAULT_DATA_BITS, SerialPort::DEFAULT_STOP_BITS, SerialPort::DEFAULT_PARITY, SerialPort::DEFAULT_FLOW_CONTROL}
+{
+
+}
+
+SerialPortSettings::SerialPortSettings(uint32_t baudRate, DataBits dataBits, StopBits stopBits, Parity parity, FlowControl flowControl) :
+    baudRate{baudRate},
+    dataBits{dataBits},
+    stopBits{stopBits},
+    parity{parity},
+    flowControl{flowControl}
+{
+
+}
+
+SerialPortSettings::SerialPortSettings(BaudRate baudRate, DataBits dataBits, StopBits stopBits, Parity parity, FlowControl flowControl) :
+    SerialPortSettings{SerialPort::toBaudRateValue(baudRate), dataBits, stopBits, parity, flowControl}
+{
+
+}
+
+bool SerialPortSettings::operator==(const SerialPortSettings &rhs) const {
+    return ( (this->baudRate == rhs.baudRate) &&
+             (this->dataBits == rhs.dataBits) &&
+             (this->stopBits == rhs.stopBits) &&
+             (this->parity == rhs.parity) &&
+             (this->flowControl == rhs.flowControl) );
+}
+
+bool SerialPortSettings::operator!=(const SerialPortSettings &rhs) const {
+    return !(*this == rhs);
+}
+
+//State shared between the reader thread (the only producer) and the thread calling read() (the only consumer)
+struct SerialPort::BackgroundReader {
+    explicit BackgroundReader(size_t capacity) :
+        queue{capacity},
+        thread{},
+        running{false},
+        consumerWaiting{false},
+        droppedBytes{0},
+        highWaterMark{0},
+        wakeMutex{},
+        wakeCondition{},
+        failure{nullptr}
+    {
+
+    }
+
+    SpscByteQueue queue;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> consumerWaiting;
+    std::atomic<uint64_t> droppedBytes;
+    std::atomic<size_t> highWaterMark;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    //Only written by the reader thread before it clears running
+    std::exception_ptr failure;
+};
+
+SerialPort::SerialPort(const std::string &name, BaudRate baudRate, DataBits dataBits, StopBits stopBits, Parity parity, FlowControl flowControl, const std::string &lineEnding) :
+        m_portName{name},
+        m_portNumber{0},
+        m_baudRate{baudRate},
+        m_baudRateValue{toBaudRateValue(baudRate)},
+        m_customBaudRate{false},
+        m_stopBits{stopBits},
+        m_dataBits{dataBits},
+        m_parity{parity},
+        m_flowControl{flowControl},
+        m_fileDescriptor{INVALID_FILE_DESCRIPTOR},
+        m_backgroundReader{nullptr}
+{
+    this->setLineEnding(lineEnding);
+    std::pair<int, std::string> truePortNameAndNumber{getPortNameAndNumber(this->m_portName)};
+    this->m_portNumber = truePortNameAndNumber.first;
+    this->m_portName = truePortNameAndNumber.second;
+}
+
+
+file_descriptor_t SerialPort::getFileDescriptor() const {
+    return this->m_fileDescriptor;
+}
+
+
+void SerialPort::openPort() {
+    if (!isAvailableSerialPort(this->portName())) {
+        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): ERROR: " + this->portName() + " is not a currently available serial port (is something else using it?)");
+    }
+#if defined(_WIN32)
+    auto handle = CreateFileA(this->m_portName.c_str(), GENERIC_READ|GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if(handle == INVALID_FILE_DESCRIPTOR) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): CreateFileA(LPCSTR, DWORD, DWORD, LPSECURITY_ATTRIBUTES, DWORD, DWORD, HANDLE, HANDLE): Unable to open serial port " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+
+    //Get full configuration
+    if (!GetCommConfig(handle, &this->m_portSettings, &this->m_portSettings.dwSize)) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): GetCommConfig(HANDLE, LPCOMMCONFIG, LPDWORD): Unable to get current communication configuration for  " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+
+    //Get DCB settings
+    if (!GetCommState(handle, &(this->m_portSettings.dcb))) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): GetCommState(HANDLE, LPDCB): Unable to get current communication state for  " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+
+    /*set up parameters*/
+    this->m_portSettings.dcb.fBinary=TRUE;
+    this->m_portSettings.dcb.fInX=FALSE;
+    this->m_portSettings.dcb.fOutX=FALSE;
+    this->m_portSettings.dcb.fAbortOnError=FALSE;
+    this->m_portSettings.dcb.fNull=FALSE;
+#else
+    auto fileHandle = ::open(this->portName().c_str(), O_RDWR);
+    if (fileHandle == INVALID_FILE_DESCRIPTOR) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): ERROR: open(" + this->portName() + ") returned error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    this->m_fileDescriptor = fileHandle;
+    if (tcgetattr(this->getFileDescriptor(), &this->m_oldPortSettings) != 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::openPort(): tcgetattr(int, termios *): Unable to get current attributes for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    memset(&this->m_portSettings, 0, sizeof(this->m_portSettings));
+    this->m_portSettings = this->m_oldPortSettings;
+    cfmakeraw(&this->m_portSettings);
+
+    this->m_portSettings.c_lflag &= (~(ICANON|ECHO|ECHOE|ECHOK|ECHONL|ISIG));
+    this->m_portSettings.c_iflag &= (~(INPCK|IGNPAR|PARMRK|ISTRIP|ICRNL|IXANY));
+    this->m_portSettings.c_oflag &= (~OPOST);
+    //Reads only happen once poll() reports data, so they should return immediately with whatever has arrived
+    this->m_portSettings.c_cc[VMIN]= 0;
+    this->m_portSettings.c_cc[VTIME]= 0;
+    this->m_portSettings.c_cflag |= (CLOCAL | CREAD);
+#endif
+
+    //The whole configuration goes to the device in a single update
+    this->writeSettings(this->settings());
+    this->setReadTimeout(this->readTimeoutDuration());
+
+    this->enableDTR();
+    this->enableRTS();
+}
+
+void SerialPort::setReadTimeout(std::chrono::microseconds timeout) {
+    IByteStream::setReadTimeout(timeout);
+    if (!this->isOpen()) {
+        return;
+    }
+    //Timeouts are enforced by waiting for data before each read, so only Windows needs the driver told about them
+#if defined(_WIN32)
+    COMMTIMEOUTS commTimeouts{0, 0, 0, 0, 0};
+    commTimeouts.ReadIntervalTimeout         = MAXDWORD;
+    commTimeouts.ReadTotalTimeoutMultiplier  = 0;
+    commTimeouts.ReadTotalTimeoutConstant    = static_cast<DWORD>(this->readTimeout());
+    commTimeouts.WriteTotalTimeoutMultiplier = 0;
+    commTimeouts.WriteTotalTimeoutConstant   = static_cast<DWORD>(this->writeTimeout());
+
+    if(!SetCommTimeouts(this->m_fileDescriptor, &commTimeouts)) {
+        auto errorCode = getLastError();
+        this->closePort();
+        throw std::runtime_error("CppSerialPort::SerialPort::setReadTimeout(std::chrono::microseconds): SetCommTimeouts(HANDLE, COMMTIMEOUTS*): Unable to set timeout settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#endif //defined(_WIN32)
+}
+
+ByteArray SerialPort::readAvailable() {
+    if (this->isChunkTimestamping()) {
+        return IByteStream::readAvailable();
+    }
+    auto pendingBytes = this->bytesAvailableOnDevice();
+    std::vector<char> returnBytes(this->readBuffer().size() + pendingBytes);
+    auto returnSize = this->readBuffer().read(returnBytes.data(), returnBytes.size());
+    if (pendingBytes > 0) {
+        returnSize += this->readFromDevice(returnBytes.data() + returnSize, pendingBytes, std::chrono::steady_clock::now());
+    }
+    returnBytes.resize(returnSize);
+    ByteArray returnArray{};
+    returnArray = std::move(returnBytes);
+    return returnArray;
+}
+
+size_t SerialPort::bytesAvailableOnDevice() {
+    if (!this->isOpen()) {
+        return 0;
+    }
+    if (this->m_backgroundReader) {
+        return this->m_backgroundReader->queue.size();
+    }
+#if defined(_WIN32)
+    DWORD commErrors{};
+    COMSTAT commStatus{0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    if (ClearCommError(this->m_fileDescriptor, &commErrors, &commStatus) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::bytesAvailableOnDevice(): ClearCommError(HANDLE, LPDWORD, LPCOMSTAT) error: " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    return static_cast<size_t>(commStatus.cbInQue);
+#else
+    int bytesAvailable{0};
+    if (ioctl(this->getFileDescriptor(), FIONREAD, &bytesAvailable) == -1) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::bytesAvailableOnDevice(): ioctl(int, int, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    return static_cast<size_t>(bytesAvailable);
+#endif //defined(_WIN32)
+}
+
+size_t SerialPort::readFromDevice(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) {
+    if (this->m_backgroundReader) {
+        return this->readFromBackgroundReader(buffer, maximum, deadline);
+    }
+    try {
+        return this->readFromPort(buffer, maximum, deadline);
+    } catch (const SerialPortDisconnectedException &e) {
+        (void)e;
+        this->closePort();
+        throw;
+    }
+}
+
+size_t SerialPort::readFromPort(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) {
+#if defined(_WIN32)
+    do {
+        DWORD commErrors{};
+        COMSTAT commStatus{0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        auto clearErrorsResult = ClearCommError(this->m_fileDescriptor, &commErrors, &commStatus);
+        if (clearErrorsResult == 0) {
+            const auto errorCode = getLastError();
+            throw std::runtime_error("ClearCommError(HANDLE, LPDWORD, LPCOMSTAT) error: " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ")");
+        }
+        DWORD maxBytes{std::min(commStatus.cbInQue, static_cast<DWORD>(maximum))};
+        if (maxBytes == 0) {
+            continue;
+        }
+        DWORD returnedBytes{0};
+        auto result = ReadFile(this->m_fileDescriptor, buffer, maxBytes, &returnedBytes, nullptr);
+        if (result == 0) {
+            const auto errorCode = getLastError();
+            throw std::runtime_error("ReadFile(HANDLE, LPDWORD, DWORD, LPDWORD, LPOVERLAPPED) error: " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ")");
+        }
+        if (returnedBytes > 0) {
+            if (this->isChunkTimestamping()) {
+                this->setLastReceiveTimestamp(ReceiveTimestamp{std::chrono::nanoseconds{0}, std::chrono::nanoseconds{0}, std::chrono::steady_clock::now()});
+            }
+            return static_cast<size_t>(returnedBytes);
+        }
+    } while (std::chrono::steady_clock::now() < deadline);
+    return 0;
+
+#else
+    //Wait for data to arrive until the deadline, then read and return
+    //A hung up tty always polls as readable and then reads 0 bytes (or fails with EIO),
+    //so disconnection only needs to be checked once a read comes back empty
+    if (DescriptorWaiter::waitForReadable(this->getFileDescriptor(), deadline)) {
+        auto returnedBytes = ::read(this->getFileDescriptor(), buffer, maximum);
+        if (returnedBytes <= 0) {
+            if ( ( (returnedBytes == -1) && (getLastError() == EIO) ) || (this->isDisconnected()) ) {
+                throw SerialPortDisconnectedException{this->m_portName, "CppSerialPort::SerialPort::read(): The serial port has been disconnected from the system"};
+            }
+            return 0;
+        }
+        if (this->isChunkTimestamping()) {
+            this->setLastReceiveTimestamp(ReceiveTimestamp{std::chrono::nanoseconds{0}, std::chrono::nanoseconds{0}, std::chrono::steady_clock::now()});
+        }
+        return static_cast<size_t>(returnedBytes);
+    }
+    return 0;
+#endif //defined(_WIN32)
+}
+
+size_t SerialPort::readFromBackgroundReader(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) {
+    auto &reader = *this->m_backgroundReader;
+    auto returnSize = reader.queue.pop(buffer, maximum);
+    if ( (returnSize == 0) && (std::chrono::steady_clock::now() < deadline) && (reader.running.load()) ) {
+        std::unique_lock<std::mutex> wakeLock{reader.wakeMutex};
+        //Announce the wait before checking the queue, so the reader cannot publish in between and skip the notify
+        reader.consumerWaiting.store(true);
+        reader.wakeCondition.wait_until(wakeLock, deadline, [&reader]() {
+            return ( (!reader.queue.empty()) || (!reader.running.load()) );
+        });
+        reader.consumerWaiting.store(false);
+        wakeLock.unlock();
+        returnSize = reader.queue.pop(buffer, maximum);
+    }
+    if ( (returnSize == 0) && (!reader.running.load()) && (reader.failure) ) {
+        auto failure = reader.failure;
+        this->closePort();
+        std::rethrow_exception(failure);
+    }
+    return returnSize;
+}
+
+void SerialPort::runBackgroundReader() {
+    auto &reader = *this->m_backgroundReader;
+    char overflowChunk[READ_CHUNK_SIZE];
+    try {
+        while (reader.running.load()) {
+            auto writeSpan = reader.queue.writeSpan();
+            if (writeSpan.second == 0) {
+                //Keep draining the tty while the consumer is stalled so the kernel buffer never overruns,
+                //and account for what was thrown away instead
+                reader.droppedBytes += this->readFromPort(overflowChunk, sizeof(overflowChunk), deadlineAfter(std::chrono::milliseconds{BACKGROUND_READER_POLL_INTERVAL}));
+                continue;
+            }
+            auto returnSize = this->readFromPort(writeSpan.first, writeSpan.second, deadlineAfter(std::chrono::milliseconds{BACKGROUND_READER_POLL_INTERVAL}));
+            if (returnSize == 0) {
+                continue;
+            }
+            reader.queue.commitWrite(returnSize);
+            auto queuedBytes = reader.queue.size();
+            if (queuedBytes > reader.highWaterMark.load(std::memory_order_relaxed)) {
+                reader.highWaterMark.store(queuedBytes, std::memory_order_relaxed);
+            }
+            if (reader.consumerWaiting.load()) {
+                std::lock_guard<std::mutex> wakeLock{reader.wakeMutex};
+                reader.wakeCondition.notify_one();
+            }
+        }
+    } catch (...) {
+        reader.failure = std::current_exception();
+    }
+    std::lock_guard<std::mutex> wakeLock{reader.wakeMutex};
+    reader.running.store(false);
+    reader.wakeCondition.notify_all();
+}
+
+void SerialPort::startBackgroundReader(size_t capacity) {
+    if (!this->isOpen()) {
+        throw std::runtime_error("CppSerialPort::SerialPort::startBackgroundReader(size_t): " + this->portName() + " must be open before starting a background reader");
+    }
+    if (this->m_backgroundReader) {
+        return;
+    }
+    if (this->isChunkTimestamping()) {
+        throw std::runtime_error("CppSerialPort::SerialPort::startBackgroundReader(size_t): " + this->portName() + " is in timestamped capture mode (call setTimestampedCapture(false) first)");
+    }
+    this->m_backgroundReader.reset(new BackgroundReader{capacity});
+    this->m_backgroundReader->running.store(true);
+    this->m_backgroundReader->thread = std::thread{&SerialPort::runBackgroundReader, this};
+}
+
+void SerialPort::stopBackgroundReader() {
+    if (!this->m_backgroundReader) {
+        return;
+    }
+    auto &reader = *this->m_backgroundReader;
+    reader.running.store(false);
+    if (reader.thread.joinable()) {
+        reader.thread.join();
+    }
+    //Hand anything already captured back to the normal read buffer, so switching modes never loses bytes
+    while (!reader.queue.empty()) {
+        auto writeSpan = this->readBuffer().writeSpan(reader.queue.size());
+        this->commitReadBuffer(reader.queue.pop(writeSpan.first, writeSpan.second));
+    }
+    this->m_backgroundReader.reset();
+}
+
+void SerialPort::setTimestampedCapture(bool timestampedCapture) {
+    if ( (timestampedCapture) && (this->m_backgroundReader) ) {
+        throw std::runtime_error("CppSerialPort::SerialPort::setTimestampedCapture(bool): " + this->portName() + " has a background reader running (call stopBackgroundReader() first)");
+    }
+    this->setChunkTimestamping(timestampedCapture);
+}
+
+bool SerialPort::isTimestampedCapture() const {
+    return this->isChunkTimestamping();
+}
+
+bool SerialPort::isBackgroundReaderRunning() const {
+    return ( (this->m_backgroundReader) && (this->m_backgroundReader->running.load()) );
+}
+
+uint64_t SerialPort::backgroundReaderDroppedBytes() const {
+    return (this->m_backgroundReader ? this->m_backgroundReader->droppedBytes.load() : 0);
+}
+
+size_t SerialPort::backgroundReaderHighWaterMark() const {
+    return (this->m_backgroundReader ? this->m_backgroundReader->highWaterMark.load() : 0);
+}
+
+bool SerialPort::isDisconnected() {
+#if defined(_WIN32)
+    auto availablePorts = SerialPort::availableSerialPorts();
+    return (availablePorts.find(this->m_portName) == availablePorts.end());
+#else
+    if (!this->isOpen()) {
+        return true;
+    }
+    //When the device goes away, the kernel hangs up the tty, which poll() reports on the open descriptor
+    //This is one syscall, instead of probing every possible serial port name on the system
+    auto events = DescriptorWaiter::wait(this->getFileDescriptor(), 0, std::chrono::steady_clock::now());
+    return ( (events & (POLLHUP | POLLERR | POLLNVAL)) != 0 );
+#endif //defined(_WIN32)
+}
+
+ssize_t SerialPort::write(char c) {
+#if defined(_WIN32)
+    DWORD writtenBytes{};
+    auto result = WriteFile(this->getFileDescriptor(), &c, 1, &writtenBytes, nullptr);
+    if (result == 0) {
+        return (getLastError() == EAGAIN ? 0 : writtenBytes);
+    }
+#else
+    auto writtenBytes = ::write(this->getFileDescriptor(), &c, 1);
+#endif //defined(_WIN32)
+    if (writtenBytes != 1) {
+        return (getLastError() == EAGAIN ? 0 : writtenBytes);
+    }
+    return writtenBytes;
+}
+
+ssize_t SerialPort::write(const char *bytes, size_t numberOfBytes) {
+#if defined(_WIN32)
+    DWORD writtenBytes{};
+    auto result = WriteFile(this->getFileDescriptor(), bytes, numberOfBytes, &writtenBytes, nullptr);
+    if (result == 0) {
+        return (getLastError() == EAGAIN ? 0 : writtenBytes);
+    }
+#else
+    auto writtenBytes = ::write(this->m_fileDescriptor, bytes, numberOfBytes);
+#endif //defined(_WIN32)
+    if (writtenBytes != static_cast<long>(numberOfBytes)) {
+        return (getLastError() == EAGAIN ? 0 : writtenBytes);
+    }
+    return writtenBytes;
+}
+
+ssize_t SerialPort::writeBuffers(const ConstBuffer *buffers, size_t count) {
+#if defined(_WIN32)
+    return IByteStream::writeBuffers(buffers, count);
+#else
+    std::vector<iovec> ioVectors(std::min<size_t>(count, IOV_MAX));
+    size_t numberOfBytes{0};
+    for (size_t i = 0; i < ioVectors.size(); i++) {
+        ioVectors[i].iov_base = const_cast<char *>(buffers[i].data);
+        ioVectors[i].iov_len = buffers[i].length;
+        numberOfBytes += buffers[i].length;
+    }
+    auto writtenBytes = ::writev(this->m_fileDescriptor, ioVectors.data(), static_cast<int>(ioVectors.size()));
+    if (writtenBytes != static_cast<long>(numberOfBytes)) {
+        return (getLastError() == EAGAIN ? 0 : writtenBytes);
+    }
+    return writtenBytes;
+#endif //defined(_WIN32)
+}
+
+void SerialPort::closePort() {
+    this->stopBackgroundReader();
+    if (!this->isOpen()) {
+        return;
+    }
+    try {
+#if defined(_WIN32)
+    CancelIo(this->m_fileDescriptor);
+    CloseHandle(this->m_fileDescriptor);
+#else
+        //TODO: Check error codes for these functions
+    std::memcpy(&this->m_portSettings, &this->m_oldPortSettings, sizeof(this->m_portSettings));
+    this->m_portSettings = this->m_oldPortSettings;
+    this->applyPortSettings();
+    auto result = ::close(this->m_fileDescriptor);
+        (void)result;
+#endif
+    } catch (const std::exception &e) {
+        std::cerr << "CppSerialPort::SerialPort::closePort(): Exception caught: \"" << e.what() << "\"" << std::endl;
+    }
+    this->m_fileDescriptor = INVALID_FILE_DESCRIPTOR;
+}
+
+modem_status_t SerialPort::getModemStatus() const {
+#if defined(_WIN32)
+    modem_status_t status{0};
+    if (GetCommModemStatus(this->m_fileDescriptor, &status) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::getModemStatus(): GetCommModemStatus(HANDLE, LPDWORD): Unable to get modem status for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    return status;
+#else
+    modem_status_t status{0};
+if(ioctl(this->getFileDescriptor(), TIOCMGET, &status) == -1) {
+    const auto errorCode = getLastError();
+    throw std::runtime_error("CppSerialPort::SerialPort::getModemStatus(): ioctl(int, int, int): Unable to get modem settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+}
+#endif //defined(_WIN32)
+    return status;
+}
+
+void SerialPort::enableDTR() {
+    if (!this->isOpen()) {
+        return;
+    }
+#if defined(_WIN32)
+    if (EscapeCommFunction(this->m_fileDescriptor, SETDTR) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::enableDTR(): EscapeCommFunction(HANDLE, DWORD): Unable to set DTR settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#else
+    modem_status_t status{this->getModemStatus()};
+status |= TIOCM_DTR;
+if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
+    const auto errorCode = getLastError();
+    throw std::runtime_error("CppSerialPort::SerialPort::enableDTR(): ioctl(int, int, int): Unable to set DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+}
+#endif
+}
+
+void SerialPort::disableDTR() {
+    if (!this->isOpen()) {
+        return;
+    }
+#if defined(_WIN32)
+    if (EscapeCommFunction(this->m_fileDescriptor, CLRDTR) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::disableDTR(): EscapeCommFunction(HANDLE, DWORD): Unable to reset DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#else
+    modem_status_t status{this->getModemStatus()};
+status &= ~TIOCM_DTR;
+if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
+    const auto errorCode = getLastError();
+    throw std::runtime_error("CppSerialPort::SerialPort::disableDTR(): ioctl(int, int, int): Unable to reset DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+}
+#endif
+}
+
+void SerialPort::enableRTS() {
+    if (!this->isOpen()) {
+        return;
+    }
+#if defined(_WIN32)
+    if (EscapeCommFunction(this->m_fileDescriptor, SETRTS) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::enableRTS(): EscapeCommFunction(HANDLE, DWORD): Unable to set RTS for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#else
+    modem_status_t status{this->getModemStatus()};
+status |= TIOCM_RTS;
+if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
+    const auto errorCode = getLastError();
+    throw std::runtime_error("CppSerialPort::SerialPort::enableRTS(): ioctl(int, int, int): Unable to set RTS for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+}
+#endif
+}
+
+void SerialPort::disableRTS() {
+    if (!this->isOpen()) {
+        return;
+    }
+#if defined(_WIN32)
+    if (EscapeCommFunction(this->m_fileDescriptor, CLRRTS) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::disableRTS(): EscapeCommFunction(HANDLE, DWORD): Unable to reset RTS for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#else
+    modem_status_t status{this->getModemStatus()};
+status &= ~TIOCM_RTS;
+if(ioctl(this->getFileDescriptor(), TIOCMSET, &status) == -1) {
+    const auto errorCode = getLastError();
+    throw std::runtime_error("CppSerialPort::SerialPort::disableRTS(): ioctl(int, int, int): Unable to reset DTR for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+}
+#endif
+}
+
+bool SerialPort::isDCDEnabled() const {
+    if (!this->isOpen()) {
+        return false;
+    }
+#if defined(_WIN32)
+    return static_cast<bool>(this->getModemStatus() & MS_RLSD_ON);
+#else
+    return static_cast<bool>(this->getModemStatus() & TIOCM_CAR);
+#endif
+}
+
+
+bool SerialPort::isCTSEnabled() const {
+    if (!this->isOpen()) {
+        return false;
+    }
+#if defined(_WIN32)
+    return static_cast<bool>(this->getModemStatus() & MS_CTS_ON);
+#else
+    return static_cast<bool>(this->getModemStatus() & TIOCM_CTS);
+#endif
+}
+
+bool SerialPort::isDSREnabled() const {
+    if (!this->isOpen()) {
+        return false;
+    }
+#if defined(_WIN32)
+    return static_cast<bool>(this->getModemStatus() & MS_DSR_ON);
+#else
+    return static_cast<bool>(this->getModemStatus() & TIOCM_DSR);
+#endif
+}
+
+void SerialPort::flushRx() {
+    if (!this->isOpen()) {
+        return;
+    }
+    if (this->m_backgroundReader) {
+        this->m_backgroundReader->queue.clear();
+    }
+#if defined(_WIN32)
+    PurgeComm(this->m_fileDescriptor, PURGE_RXCLEAR | PURGE_RXABORT);
+#else
+    tcflush(this->getFileDescriptor(), TCIFLUSH);
+#endif
+}
+
+
+void SerialPort::flushTx() {
+    if (!this->isOpen()) {
+        return;
+    }
+#if defined(_WIN32)
+    PurgeComm(this->m_fileDescriptor, PURGE_TXCLEAR | PURGE_TXABORT);
+#else
+    tcflush(this->getFileDescriptor(), TCOFLUSH);
+#endif
+}
+
+
+bool SerialPort::isAvailableSerialPort(const std::string &name) {
+    auto availablePorts = availableSerialPorts();
+#if defined(_WIN32)
+    std::string copyName{name};
+    copyName.erase(std::remove_if(copyName.begin(), copyName.end(), [](char c) { return ( (c == '.') || (c == '\\') ); }), copyName.end());
+    return (availablePorts.find(copyName) != availablePorts.end());
+#else
+    return (availablePorts.find(name) != availablePorts.end());
+#endif //defined(_WIN32)
+}
+
+int SerialPort::fileDescriptor() const {
+#if defined(_WIN32)
+    return -1;
+#else
+    return this->m_fileDescriptor;
+#endif //defined(_WIN32)
+}
+
+bool SerialPort::isOpen() const {
+    return (this->m_fileDescriptor != INVALID_FILE_DESCRIPTOR);
+}
+
+
+void SerialPort::setDataBits(DataBits dataBits) {
+    auto newSettings = this->settings();
+    newSettings.dataBits = dataBits;
+    this->applySettings(newSettings);
+}
+
+void SerialPort::setBaudRate(BaudRate baudRate) {
+    auto newSettings = this->settings();
+    newSettings.baudRate = toBaudRateValue(baudRate);
+    this->applySettings(newSettings);
+}
+
+void SerialPort::setBaudRate(uint32_t baudRate) {
+    auto newSettings = this->settings();
+    newSettings.baudRate = baudRate;
+    this->applySettings(newSettings);
+}
+
+void SerialPort::setStopBits(StopBits stopBits) {
+    auto newSettings = this->settings();
+    newSettings.stopBits = stopBits;
+    this->applySettings(newSettings);
+}
+
+void SerialPort::setParity(Parity parity) {
+    auto newSettings = this->settings();
+    newSettings.parity = parity;
+    this->applySettings(newSettings);
+}
+
+void SerialPort::setFlowControl(FlowControl flowControl) {
+    auto newSettings = this->settings();
+    newSettings.flowControl = flowControl;
+    this->applySettings(newSettings);
+}
+
+SerialPortSettings SerialPort::settings() const {
+    return SerialPortSettings{this->m_baudRateValue, this->m_dataBits, this->m_stopBits, this->m_parity, this->m_flowControl};
+}
+
+void SerialPort::applySettings(const SerialPortSettings &settings) {
+    //Every tcsetattr() can be a round trip to a USB adapter and glitch the line, so an unchanged configuration is left alone
+    if (settings == this->settings()) {
+        return;
+    }
+    this->writeSettings(settings);
+}
+
+void SerialPort::writeSettings(const SerialPortSettings &settings) {
+    if (settings.baudRate == 0) {
+        throw std::runtime_error("CppSerialPort::SerialPort::applySettings(const SerialPortSettings &): baudRate must be greater than 0");
+    }
+    if ( (settings.stopBits == StopBits::StopTwo) && (settings.dataBits == DataBits::DataFive) ) {
+        throw std::runtime_error("CppSerialPort::SerialPort::applySettings(const SerialPortSettings &): Five data bits cannot be used with two stop bits");
+    }
+#if defined(_WIN32)
+    if ( (settings.stopBits == StopBits::StopOneFive) && (settings.dataBits != DataBits::DataFive) ) {
+        throw std::runtime_error("CppSerialPort::SerialPort::applySettings(const SerialPortSettings &): 1.5 stop bits can only be used with 5 data bits");
+    }
+#else
+    if ( (settings.parity == Parity::ParitySpace) && (settings.dataBits == DataBits::DataEight) ) {
+        throw std::runtime_error("CppSerialPort::SerialPort::applySettings(const SerialPortSettings &): Eight data bits cannot be used with space parity");
+    }
+#endif //defined(_WIN32)
+
+    //Everything is worked out on a copy, so the device sees one update and a failure leaves the old settings in place
+    auto portSettings = this->m_portSettings;
+    auto baudRate = this->m_baudRate;
+    auto customBaudRate = false;
+    BaudRate standardBaudRate{};
+    auto isStandardBaudRate = toStandardBaudRate(settings.baudRate, &standardBaudRate);
+    if (isStandardBaudRate) {
+        baudRate = standardBaudRate;
+    }
+#if defined(_WIN32)
+    portSettings.dcb.BaudRate = static_cast<DWORD>(settings.baudRate);
+    portSettings.dcb.ByteSize = static_cast<BYTE>(settings.dataBits);
+    portSettings.dcb.StopBits = static_cast<BYTE>(settings.stopBits);
+    portSettings.dcb.fParity = (settings.parity == Parity::ParityNone) ? FALSE : TRUE;
+    portSettings.dcb.Parity = static_cast<unsigned char>(settings.parity);
+    if (settings.flowControl == FlowControl::FlowOff) {
+        portSettings.dcb.fOutxCtsFlow = FALSE;
+        portSettings.dcb.fRtsControl = RTS_CONTROL_DISABLE;
+        portSettings.dcb.fInX = FALSE;
+        portSettings.dcb.fOutX = FALSE;
+    } else if (settings.flowControl == FlowControl::FlowXonXoff) {
+        portSettings.dcb.fOutxCtsFlow = FALSE;
+        portSettings.dcb.fRtsControl = RTS_CONTROL_DISABLE;
+        portSettings.dcb.fInX = TRUE;
+        portSettings.dcb.fOutX = TRUE;
+    } else if (settings.flowControl == FlowControl::FlowHardware) {
+        portSettings.dcb.fOutxCtsFlow = TRUE;
+        portSettings.dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
+        portSettings.dcb.fInX = FALSE;
+        portSettings.dcb.fOutX = FALSE;
+    }
+#else
+    if (isStandardBaudRate) {
+        if ( (cfsetispeed(&portSettings, static_cast<speed_t>(standardBaudRate)) == -1) || (cfsetospeed(&portSettings, static_cast<speed_t>(standardBaudRate)) == -1) ) {
+            const auto errorCode = getLastError();
+            throw std::runtime_error("CppSerialPort::SerialPort::applySettings(const SerialPortSettings &): cfsetspeed(port_settings_t *, speed_t): Unable to set baud rate settings for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+    } else {
+#    if defined(__linux__) || defined(__APPLE__)
+        //applyPortSettings() puts the rate in place on top of the termios settings
+        customBaudRate = true;
+#    elif B9600 == 9600
+        //The BSDs use the plain numbers as speed_t, so any rate goes straight through
+        if ( (cfsetispeed(&portSettings, static_cast<speed_t>(settings.baudRate)) == -1) || (cfsetospeed(&portSettings, static_cast<speed_t>(settings.baudRate)) == -1) ) {
+            const auto errorCode = getLastError();
+            throw std::runtime_error("CppSerialPort::SerialPort::applySettings(const SerialPortSettings &): cfsetspeed(port_settings_t *, speed_t): Unable to set " + std::to_string(settings.baudRate) + " baud for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+#    else
+        throw std::runtime_error("CppSerialPort::SerialPort::applySettings(const SerialPortSettings &): " + std::to_string(settings.baudRate) + " baud is not a standard rate, and other rates are not supported on this platform");
+#    endif //defined(__linux__) || defined(__APPLE__)
+    }
+
+    portSettings.c_cflag &= (~CSIZE);
+    portSettings.c_cflag |= static_cast<tcflag_t>(settings.dataBits);
+
+    if (settings.stopBits == StopBits::StopOne) {
+        portSettings.c_cflag &= (~CSTOPB);
+    } else if (settings.stopBits == StopBits::StopTwo) {
+        portSettings.c_cflag |= CSTOPB;
+    }
+
+    portSettings.c_cflag &= (~(PARENB | PARODD));
+    if (settings.parity == Parity::ParityNone) {
+        portSettings.c_iflag &= (~INPCK);
+        portSettings.c_iflag |= IGNPAR;
+    } else if (settings.parity == Parity::ParityEven) {
+        portSettings.c_cflag |= PARENB;
+        portSettings.c_iflag |= INPCK; //Set parity
+        portSettings.c_iflag &= (~IGNPAR); //Reset ignore parity
+    } else if (settings.parity == Parity::ParityOdd) {
+        portSettings.c_cflag |= (PARENB | PARODD);
+        portSettings.c_iflag |= INPCK; //Set parity
+        portSettings.c_iflag &= (~IGNPAR); //Reset ignore parity
+    } else if (settings.parity == Parity::ParitySpace) {
+        //Simulate space by adding extra data bit
+        portSettings.c_iflag &= (~INPCK);
+        portSettings.c_iflag |= IGNPAR;
+        portSettings.c_cflag &= (~CSIZE);
+        portSettings.c_cflag |= (settings.dataBits == DataBits::DataFive) ? CS6 : ( (settings.dataBits == DataBits::DataSix) ? CS7 : CS8 );
+    }
+
+    if (settings.flowControl == FlowControl::FlowOff) {
+        portSettings.c_cflag &= (~CRTSCTS);
+        portSettings.c_iflag &= (~(IXON | IXOFF | IXANY));
+    } else if (settings.flowControl == FlowControl::FlowXonXoff) {
+        portSettings.c_cflag &= (~CRTSCTS);
+        portSettings.c_iflag |= (IXON|IXOFF|IXANY);
+    } else if (settings.flowControl == FlowControl::FlowHardware) {
+        portSettings.c_cflag |= CRTSCTS;
+        portSettings.c_iflag &= (~(IXON|IXOFF|IXANY));
+    }
+#endif //defined(_WIN32)
+
+    auto previousPortSettings = this->m_portSettings;
+    auto previousBaudRateValue = this->m_baudRateValue;
+    auto previousCustomBaudRate = this->m_customBaudRate;
+    this->m_portSettings = portSettings;
+    this->m_baudRateValue = settings.baudRate;
+    this->m_customBaudRate = customBaudRate;
+    try {
+        this->applyPortSettings();
+    } catch (...) {
+        this->m_portSettings = previousPortSettings;
+        this->m_baudRateValue = previousBaudRateValue;
+        this->m_customBaudRate = previousCustomBaudRate;
+        throw;
+    }
+    this->m_baudRate = baudRate;
+    this->m_dataBits = settings.dataBits;
+    this->m_stopBits = settings.stopBits;
+    this->m_parity = settings.parity;
+    this->m_flowControl = settings.flowControl;
+}
+
+void SerialPort::applyPortSettings() {
+    if (!this->isOpen()) {
+        return;
+    }
+#if defined(_WIN32)
+    if (SetCommConfig(this->m_fileDescriptor, &this->m_portSettings, sizeof(COMMCONFIG)) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::applyPortSettings(): SetCommConfig(HANDLE, COMMCONFIG, DWORD): Unable to apply serial port attributes for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#else
+#    if defined(__linux__)
+    //A plain tcsetattr() would put the B* rate in c_cflag back in place, so custom rates send everything through TCSETS2
+    if (this->m_customBaudRate) {
+        Termios2::Attributes attributes{};
+        attributes.inputFlags = static_cast<uint32_t>(this->m_portSettings.c_iflag);
+        attributes.outputFlags = static_cast<uint32_t>(this->m_portSettings.c_oflag);
+        attributes.controlFlags = static_cast<uint32_t>(this->m_portSettings.c_cflag);
+        attributes.localFlags = static_cast<uint32_t>(this->m_portSettings.c_lflag);
+        attributes.lineDiscipline = this->m_portSettings.c_line;
+        memcpy(attributes.controlCharacters, this->m_portSettings.c_cc, sizeof(attributes.controlCharacters));
+        Termios2::setAttributes(this->getFileDescriptor(), attributes, this->m_baudRateValue);
+        return;
+    }
+#    endif //defined(__linux__)
+    if (tcsetattr(this->getFileDescriptor(), TCSANOW, &this->m_portSettings) == -1) {
+    const auto errorCode = getLastError();
+    throw std::runtime_error("CppSerialPort::SerialPort::applyPortSettings(): tcsetattr(int, int, termios *): Unable to apply serial port attributes for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+}
+#    if defined(__APPLE__)
+    //tcsetattr() only takes the standard rates, so anything else is set on top of it
+    if (this->m_customBaudRate) {
+        speed_t speed{static_cast<speed_t>(this->m_baudRateValue)};
+        if (ioctl(this->getFileDescriptor(), IOSSIOSPEED, &speed) == -1) {
+            const auto errorCode = getLastError();
+            throw std::runtime_error("CppSerialPort::SerialPort::applyPortSettings(): ioctl(int, IOSSIOSPEED, speed_t *): Unable to set " + std::to_string(this->m_baudRateValue) + " baud for " + this->portName() + ": error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+    }
+#    endif //defined(__APPLE__)
+#endif //defined(_WIN32)
+}
+
+
+BaudRate SerialPort::baudRate() const {
+    return this->m_baudRate;
+}
+
+uint32_t SerialPort::baudRateValue() const {
+    return this->m_baudRateValue;
+}
+
+uint32_t SerialPort::actualBaudRate() const {
+    if (!this->isOpen()) {
+        return this->m_baudRateValue;
+    }
+#if defined(_WIN32)
+    DCB deviceControlBlock{};
+    deviceControlBlock.DCBlength = sizeof(DCB);
+    if (GetCommState(this->m_fileDescriptor, &deviceControlBlock) == 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::actualBaudRate(): GetCommState(HANDLE, LPDCB): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    return static_cast<uint32_t>(deviceControlBlock.BaudRate);
+#elif defined(__linux__)
+    return Termios2::outputBaudRate(this->getFileDescriptor());
+#else
+    termios currentSettings{};
+    if (tcgetattr(this->getFileDescriptor(), &currentSettings) != 0) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::SerialPort::actualBaudRate(): tcgetattr(int, termios *): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#    if B9600 == 9600
+    return static_cast<uint32_t>(cfgetospeed(&currentSettings));
+#    else
+    auto speed = cfgetospeed(&currentSettings);
+    for (const auto &it : STANDARD_BAUD_RATES) {
+        if (static_cast<speed_t>(it.first) == speed) {
+            return it.second;
+        }
+    }
+    return this->m_baudRateValue;
+#    endif //B9600 == 9600
+#endif //defined(_WIN32)
+}
+
+uint32_t SerialPort::toBaudRateValue(BaudRate baudRate) {
+#if defined(_WIN32)
+    return static_cast<uint32_t>(baudRate);
+#else
+    for (const auto &it : STANDARD_BAUD_RATES) {
+        if (it.first == baudRate) {
+            return it.second;
+        }
+    }
+    throw std::runtime_error("CppSerialPort::SerialPort::toBaudRateValue(BaudRate): unknown baud rate " + std::to_string(static_cast<int>(baudRate)));
+#endif //defined(_WIN32)
+}
+
+StopBits SerialPort::stopBits() const {
+    return this->m_stopBits;
+}
+
+DataBits SerialPort::dataBits() const {
+    return this->m_dataBits;
+}
+
+Parity SerialPort::parity() const {
+    return this->m_parity;
+}
+
+FlowControl SerialPort::flowControl() const {
+    return this->m_flowControl;
+}
+
+std::string SerialPort::portName() const {
+#if defined(_WIN32)
+    std::string copyName{this->m_portName};
+    copyName.erase(std::remove_if(copyName.begin(), copyName.end(), [](char c) { return ( (c == '.') || (c == '\\') ); }), copyName.end());
+    return copyName;
+#else
+    return this->m_portName;
+#endif //defined(_WIN32)
+}
+
+std::unordered_set<std::string> SerialPort::availableSerialPorts() {
+    std::unordered_set<std::string> returnSet;
+#if defined(_WIN32)
+    try {
+        HKEY hRegistryKey;
+        LONG operationResult{ RegOpenKeyExA(HKEY_LOCAL_MACHINE, SERIAL_PORT_REGISTRY_PATH, 0, KEY_READ|KEY_WOW64_64KEY, &hRegistryKey) };
+        if (operationResult != ERROR_SUCCESS) {
+            return returnSet;
+        }
+        for (DWORD index = 0; ; index++) {
+            char subKeyName[PATH_MAX];
+            DWORD cbName{ PATH_MAX };
+            operationResult = RegEnumValueA(hRegistryKey, index, subKeyName, &cbName, nullptr, nullptr, nullptr, nullptr);
+            if (operationResult != ERROR_SUCCESS) {
+                break;
+            }
+            BYTE hRegistryKeyByteValue[PATH_MAX];
+            DWORD cbType{};
+            DWORD cbData{ PATH_MAX };
+            operationResult = RegQueryValueExA(hRegistryKey, subKeyName, nullptr, &cbType, hRegistryKeyByteValue, &cbData);
+            if (operationResult != ERROR_SUCCESS) {
+                std::cerr << "CppSerialPort::SerialPort::availableSerialPorts(): RegQueryValueExA returned " << operationResult << " (" << getErrorString(operationResult) << ")" << std::endl;
+                break;
+            }
+            if ( (cbType == REG_SZ) || (cbType == REG_MULTI_SZ) || (REG_EXPAND_SZ) ) {
+                hRegistryKeyByteValue[cbData] = '\0';
+            }
+            std::string tempString{""};
+            for (unsigned int i = 0; i < cbData - 1; i++) {
+                tempString += *reinterpret_cast<char *>(&(hRegistryKeyByteValue[i]));
+            }
+            returnSet.emplace(tempString);
+        }
+        RegCloseKey(hRegistryKey);
+        return returnSet;
+    } catch (std::exception &e) {
+        (void)e;
+        return returnSet;
+    }
+#elif defined(__linux__)
+    for (const auto &it : SerialPort::availableSerialPortInfo()) {
+        returnSet.emplace(it.name);
+    }
+    return returnSet;
+#else
+    return SerialPort::probeSerialPortNames();
+#endif
+}
+
+std::unordered_set<std::string> SerialPort::probeSerialPortNames() {
+    std::unordered_set<std::string> returnSet;
+    for (auto &it : SerialPort::SERIAL_PORT_NAMES) {
+        if (IByteStream::fileExists(std::string{it})) {
+            returnSet.emplace(it);
+        }
+    }
+    return returnSet;
+}
+
+std::vector<SerialPortInfo> SerialPort::enumerateSerialPorts() {
+    std::vector<SerialPortInfo> returnVector;
+#if defined(__linux__)
+    auto ttyDirectory = opendir(SYSFS_TTY_CLASS_PATH);
+    if (ttyDirectory == nullptr) {
+        //sysfs is not mounted (some containers), so fall back to probing the known device names
+        for (const auto &it : SerialPort::probeSerialPortNames()) {
+            returnVector.push_back(makeSerialPortInfo(it));
+        }
+    } else {
+        while (auto entry = readdir(ttyDirectory)) {
+            std::string ttyName{entry->d_name};
+            SerialPortInfo serialPortInfo{makeSerialPortInfo("/dev/" + ttyName)};
+            if ( (ttyName[0] == '.') || (!IByteStream::fileExists(serialPortInfo.name)) ) {
+                continue;
+            }
+            if (pathExists(SYSFS_TTY_CLASS_PATH + ttyName + "/device")) {
+                if (readSysfsSerialPortInfo(ttyName, &serialPortInfo)) {
+                    returnVector.push_back(serialPortInfo);
+                }
+            } else if (std::any_of(AVAILABLE_PORT_NAMES_BASE.begin(), AVAILABLE_PORT_NAMES_BASE.end(), [&serialPortInfo](const char *prefix) { return serialPortInfo.name.rfind(prefix, 0) == 0; })) {
+                //Bluetooth and IrDA ttys have no backing device in sysfs, unlike virtual consoles and pseudo terminals which are skipped
+                returnVector.push_back(serialPortInfo);
+            }
+        }
+        closedir(ttyDirectory);
+    }
+#else
+    for (const auto &it : SerialPort::availableSerialPorts()) {
+        returnVector.push_back(makeSerialPortInfo(it));
+    }
+#endif //defined(__linux__)
+    std::sort(returnVector.begin(), returnVector.end(), [](const SerialPortInfo &lhs, const SerialPortInfo &rhs) { return lhs.name < rhs.name; });
+    return returnVector;
+}
+
+uint64_t SerialPort::refreshSerialPortInfo(std::vector<SerialPortInfo> *serialPortInfo) {
+    auto &cache = serialPortInfoCache();
+    std::lock_guard<std::mutex> cacheLock{cache.mutex};
+#if defined(__linux__)
+    //Device nodes come and go in /dev, so an unchanged modification time means the last scan is still valid
+    struct stat devStatus{};
+    auto haveDevStatus = (stat("/dev", &devStatus) == 0);
+    auto isStale = ( (!cache.populated) || (!haveDevStatus) ||
+                     (devStatus.st_mtim.tv_sec != cache.devModified.tv_sec) ||
+                     (devStatus.st_mtim.tv_nsec != cache.devModified.tv_nsec) );
+#else
+    auto isStale = true;
+#endif //defined(__linux__)
+    if (isStale) {
+        auto currentPorts = SerialPort::enumerateSerialPorts();
+        auto isUnchanged = (cache.populated) && (currentPorts.size() == cache.serialPortInfo.size()) &&
+                           (std::equal(currentPorts.begin(), currentPorts.end(), cache.serialPortInfo.begin(), [](const SerialPortInfo &lhs, const SerialPortInfo &rhs) { return lhs.name == rhs.name; }));
+        if (!isUnchanged) {
+            cache.generation++;
+        }
+        cache.serialPortInfo = std::move(currentPorts);
+        cache.populated = true;
+#if defined(__linux__)
+        cache.devModified = haveDevStatus ? devStatus.st_mtim : timespec{0, 0};
+#endif //defined(__linux__)
+    }
+    if (serialPortInfo) {
+        *serialPortInfo = cache.serialPortInfo;
+    }
+    return cache.generation;
+}
+
+std::vector<SerialPortInfo> SerialPort::availableSerialPortInfo() {
+    std::vector<SerialPortInfo> returnVector;
+    SerialPort::refreshSerialPortInfo(&returnVector);
+    return returnVector;
+}
+
+uint64_t SerialPort::serialPortGeneration() {
+    return SerialPort::refreshSerialPortInfo(nullptr);
+}
+
+std::vector<std::string> SerialPort::generateSerialPortNames() {
+    std::vector<std::string> returnSet;
+#if defined(_WIN32)
+    for (int i = 0; i < UCHAR_MAX; i++) {
+        returnSet.push_back(AVAILABLE_PORT_NAMES_BASE + toStdString(i));
+    }
+#else
+    for (auto &it : SerialPort::AVAILABLE_PORT_NAMES_BASE) {
+    for (int i = 0; i < UCHAR_MAX; i++) {
+        returnSet.push_back(it + toStdString(i));
+    }
+}
+#endif //defined(_WIN32)
+    return returnSet;
+}
+
+bool SerialPort::isValidSerialPortName(const std::string &serialPortName) {
+#if defined(_WIN32)
+    auto foundCom = serialPortName.find("COM");
+    if ( (foundCom == std::string::npos) || (foundCom != 0) || (serialPortName.length() == 3)) {
+        return false;
+    }
+    try {
+        int comNumber{ std::stoi(serialPortName.substr(strlen("COM"))) };
+        return ((comNumber > 0) && (comNumber < UCHAR_MAX));
+    } catch (std::exception &e) {
+        (void)e;
+        return false;
+    }
+#else
+    for (auto &it : SerialPort::AVAILABLE_PORT_NAMES_BASE) {
+    for (int i = 0; i < UCHAR_MAX; i++) {
+        if (serialPortName == (it + toStdString(i))) {
+            return true;
+        }
+    }
+}
+return false;
+#endif
+}
+
+std::pair<int, std::string> SerialPort::getPortNameAndNumber(const std::string &name) {
+#if defined(_WIN32)
+    auto foundCom = name.find("COM");
+    if ((foundCom != 0) || (name.length() == 3)) {
+        throw std::runtime_error("CppSerialPort::SerialPort::getPortNameAndNumber(const std::string &): ERROR: " + name + " is an invalid serial port name");
+    }
+    try {
+        int comNumber{ std::stoi(name.substr(3)) };
+        return std::make_pair(comNumber, AVAILABLE_PORT_NAMES_BASE + toStdString(comNumber));
+    } catch (std::exception &e) {
+        (void)e;
+        throw std::runtime_error("CppSerialPort::SerialPort::getPortNameAndNumber(const std::string &): ERROR: " + name + " is an invalid serial port name");
+    }
+#else
+    std::string str{name};
+auto iter = std::find(SERIAL_PORT_NAMES.cbegin(), SERIAL_PORT_NAMES.cend(), str);
+if (iter != SERIAL_PORT_NAMES.cend()) {
+    return std::make_pair(static_cast<int>(std::distance(SERIAL_PORT_NAMES.begin(), iter)), str);
+}
+str = name;
+if (str.find("/dev/tty") == std::string::npos) {
+    str = "/dev/tty" + str;
+}
+iter = std::find(SERIAL_PORT_NAMES.cbegin(), SERIAL_PORT_NAMES.cend(), str);
+if (iter != SERIAL_PORT_NAMES.cend()) {
+    return std::make_pair(static_cast<int>(std::distance(SERIAL_PORT_NAMES.begin(), iter)), str);
+}
+str = name;
+if (str.find("/dev/") == std::string::npos) {
+    str = "/dev/" + str;
+}
+iter = std::find(SERIAL_PORT_NAMES.cbegin(), SERIAL_PORT_NAMES.cend(), str);
+if (iter != SERIAL_PORT_NAMES.cend()) {
+    return std::make_pair(static_cast<int>(std::distance(SERIAL_PORT_NAMES.begin(), iter)), str);
+}
+//Not one of the generated names (numbers past 255, unusual drivers), but the system says it exists
+auto availablePorts = availableSerialPorts();
+for (const auto &it : {name, "/dev/" + name}) {
+    if (availablePorts.find(it) != availablePorts.end()) {
+        return std::make_pair(-1, it);
+    }
+}
+
+throw std::runtime_error("CppSerialPort::SerialPort::getPortNameAndNumber(const std::string &): ERROR: " + name + " is an invalid serial port name");
+#endif
+}
+
+
+size_t SerialPort::available() {
+    if (this->m_backgroundReader) {
+        return this->readBuffer().size() + this->m_backgroundReader->queue.size();
+    }
+    return this->readBuffer().size();
+}
+
+SerialPort::~SerialPort() {
+    this->closePort();
+}
+
+
+}
+
+//namespace CppSerialPort
@@ -0,0 +1,197 @@
+#include <CppSerialPort/SocketOptions.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#if defined(_WIN32)
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+     using sockopt_t = char;
+#else
+#    include <sys/socket.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+     using sockopt_t = int;
+#endif //defined(_WIN32)
+
+#if defined(__linux__)
+#    include <linux/net_tstamp.h>
+#endif //defined(__linux__)
+
+#include <stdexcept>
+
+using NetworkErrorInformation::getLastError;
+using NetworkErrorInformation::getErrorString;
+
+namespace CppSerialPort {
+
+SocketOptions::SocketOptions() :
+    m_options{}
+{
+
+}
+
+SocketOptions &SocketOptions::setNoDelay(bool noDelay) {
+    return this->setOption(IPPROTO_TCP, TCP_NODELAY, noDelay ? 1 : 0, "TCP_NODELAY");
+}
+
+SocketOptions &SocketOptions::setQuickAck(bool quickAck) {
+#if defined(TCP_QUICKACK)
+    return this->setOption(IPPROTO_TCP, TCP_QUICKACK, quickAck ? 1 : 0, "TCP_QUICKACK");
+#else
+    (void)quickAck;
+    throw std::runtime_error("CppSerialPort::SocketOptions::setQuickAck(bool): TCP_QUICKACK is not supported on this platform");
+#endif //defined(TCP_QUICKACK)
+}
+
+SocketOptions &SocketOptions::setReceiveBufferSize(int bytes) {
+    if (bytes <= 0) {
+        throw std::runtime_error("CppSerialPort::SocketOptions::setReceiveBufferSize(int): bytes must be greater than 0 (" + std::to_string(bytes) + " <= 0)");
+    }
+    return this->setOption(SOL_SOCKET, SO_RCVBUF, bytes, "SO_RCVBUF");
+}
+
+SocketOptions &SocketOptions::setSendBufferSize(int bytes) {
+    if (bytes <= 0) {
+        throw std::runtime_error("CppSerialPort::SocketOptions::setSendBufferSize(int): bytes must be greater than 0 (" + std::to_string(bytes) + " <= 0)");
+    }
+    return this->setOption(SOL_SOCKET, SO_SNDBUF, bytes, "SO_SNDBUF");
+}
+
+SocketOptions &SocketOptions::setBusyPoll(std::chrono::microseconds busyPoll) {
+#if defined(SO_BUSY_POLL)
+    return this->setOption(SOL_SOCKET, SO_BUSY_POLL, static_cast<int>(busyPoll.count()), "SO_BUSY_POLL");
+#else
+    (void)busyPoll;
+    throw std::runtime_error("CppSerialPort::SocketOptions::setBusyPoll(std::chrono::microseconds): SO_BUSY_POLL is not supported on this platform");
+#endif //defined(SO_BUSY_POLL)
+}
+
+SocketOptions &SocketOptions::setPriority(int priority) {
+#if defined(SO_PRIORITY)
+    return this->setOption(SOL_SOCKET, SO_PRIORITY, priority, "SO_PRIORITY");
+#else
+    (void)priority;
+    throw std::runtime_error("CppSerialPort::SocketOptions::setPriority(int): SO_PRIORITY is not supported on this platform");
+#endif //defined(SO_PRIORITY)
+}
+
+SocketOptions &SocketOptions::setKeepAlive(bool keepAlive) {
+    return this->setOption(SOL_SOCKET, SO_KEEPALIVE, keepAlive ? 1 : 0, "SO_KEEPALIVE");
+}
+
+SocketOptions &SocketOptions::setKeepAlive(std::chrono::seconds idle, std::chrono::seconds interval, int probeCount) {
+    if ( (idle.count() <= 0) || (interval.count() <= 0) || (probeCount <= 0) ) {
+        throw std::runtime_error("CppSerialPort::SocketOptions::setKeepAlive(std::chrono::seconds, std::chrono::seconds, int): idle, interval and probeCount must all be greater than 0");
+    }
+    this->setKeepAlive(true);
+#if defined(TCP_KEEPIDLE)
+    this->setOption(IPPROTO_TCP, TCP_KEEPIDLE, static_cast<int>(idle.count()), "TCP_KEEPIDLE");
+#elif defined(TCP_KEEPALIVE)
+    //macOS spells TCP_KEEPIDLE this way
+    this->setOption(IPPROTO_TCP, TCP_KEEPALIVE, static_cast<int>(idle.count()), "TCP_KEEPALIVE");
+#endif //defined(TCP_KEEPIDLE)
+#if defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+    this->setOption(IPPROTO_TCP, TCP_KEEPINTVL, static_cast<int>(interval.count()), "TCP_KEEPINTVL");
+    return this->setOption(IPPROTO_TCP, TCP_KEEPCNT, probeCount, "TCP_KEEPCNT");
+#else
+    throw std::runtime_error("CppSerialPort::SocketOptions::setKeepAlive(std::chrono::seconds, std::chrono::seconds, int): keepalive intervals are not supported on this platform");
+#endif //defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+}
+
+SocketOptions &SocketOptions::setReusePort(bool reusePort) {
+#if defined(SO_REUSEPORT)
+    return this->setOption(SOL_SOCKET, SO_REUSEPORT, reusePort ? 1 : 0, "SO_REUSEPORT");
+#else
+    (void)reusePort;
+    throw std::runtime_error("CppSerialPort::SocketOptions::setReusePort(bool): SO_REUSEPORT is not supported on this platform");
+#endif //defined(SO_REUSEPORT)
+}
+
+SocketOptions &SocketOptions::setReceiveTimestamping(ReceiveTimestamping timestamping) {
+#if defined(__linux__)
+    //Only one of the two is on at a time, so switching modes never leaves both control messages coming
+    int hardwareFlags{SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE};
+    this->setOption(SOL_SOCKET, SO_TIMESTAMPNS, (timestamping == ReceiveTimestamping::Software) ? 1 : 0, "SO_TIMESTAMPNS");
+    return this->setOption(SOL_SOCKET, SO_TIMESTAMPING, (timestamping == ReceiveTimestamping::Hardware) ? hardwareFlags : 0, "SO_TIMESTAMPING");
+#elif defined(SO_TIMESTAMP)
+    if (timestamping == ReceiveTimestamping::Hardware) {
+        throw std::runtime_error("CppSerialPort::SocketOptions::setReceiveTimestamping(ReceiveTimestamping): hardware timestamps are not supported on this platform");
+    }
+    return this->setOption(SOL_SOCKET, SO_TIMESTAMP, (timestamping == ReceiveTimestamping::Software) ? 1 : 0, "SO_TIMESTAMP");
+#else
+    if (timestamping == ReceiveTimestamping::Disabled) {
+        return *this;
+    }
+    throw std::runtime_error("CppSerialPort::SocketOptions::setReceiveTimestamping(ReceiveTimestamping): receive timestamps are not supported on this platform");
+#endif //defined(__linux__)
+}
+
+SocketOptions &SocketOptions::setOption(int level, int name, int value, const std::string &description) {
+    for (auto &option : this->m_options) {
+        if ( (option.level == level) && (option.name == name) ) {
+            option.value = value;
+            return *this;
+        }
+    }
+    this->m_options.push_back(Option{level, name, value, description});
+    return *this;
+}
+
+bool SocketOptions::quickAck() const {
+#if defined(TCP_QUICKACK)
+    auto found = this->find(IPPROTO_TCP, TCP_QUICKACK);
+    return ( (found != nullptr) && (found->value != 0) );
+#else
+    return false;
+#endif //defined(TCP_QUICKACK)
+}
+
+ReceiveTimestamping SocketOptions::receiveTimestamping() const {
+#if defined(__linux__)
+    auto found = this->find(SOL_SOCKET, SO_TIMESTAMPING);
+    if ( (found != nullptr) && (found->value != 0) ) {
+        return ReceiveTimestamping::Hardware;
+    }
+    found = this->find(SOL_SOCKET, SO_TIMESTAMPNS);
+#elif defined(SO_TIMESTAMP)
+    auto found = this->find(SOL_SOCKET, SO_TIMESTAMP);
+#else
+    const Option *found{nullptr};
+#endif //defined(__linux__)
+    return ( (found != nullptr) && (found->value != 0) ) ? ReceiveTimestamping::Software : ReceiveTimestamping::Disabled;
+}
+
+bool SocketOptions::empty() const {
+    return this->m_options.empty();
+}
+
+SocketOptions &SocketOptions::merge(const SocketOptions &other) {
+    for (const auto &option : other.m_options) {
+        this->setOption(option.level, option.name, option.value, option.description);
+    }
+    return *this;
+}
+
+void SocketOptions::apply(DescriptorWaiter::descriptor_t socketDescriptor) const {
+    for (const auto &option : this->m_options) {
+        int value{option.value};
+        if (setsockopt(socketDescriptor, option.level, option.name, reinterpret_cast<const sockopt_t *>(&value), sizeof(value)) != 0) {
+            auto errorCode = getLastError();
+            throw std::runtime_error("CppSerialPort::SocketOptions::apply(descriptor_t): Setting " + option.description + " (" + std::to_string(value) + "): setsockopt(int, int, int, const void *, socklen_t): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+    }
+}
+
+const std::vector<SocketOptions::Option> &SocketOptions::options() const {
+    return this->m_options;
+}
+
+const SocketOptions::Option *SocketOptions::find(int level, int name) const {
+    for (const auto &option : this->m_options) {
+        if ( (option.level == level) && (option.name == name) ) {
+            return &option;
+        }
+    }
+    return nullptr;
+}
+
+} //namespace CppSerialPort
@@ -0,0 +1,86 @@
+#include <CppSerialPort/SpscByteQueue.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace CppSerialPort {
+
+SpscByteQueue::SpscByteQueue(size_t capacity) :
+    m_buffer{},
+    m_mask{0},
+    m_head{0},
+    m_tail{0}
+{
+    if (capacity == 0) {
+        throw std::runtime_error("CppSerialPort::SpscByteQueue::SpscByteQueue(size_t): capacity cannot be 0");
+    }
+    size_t roundedCapacity{1};
+    while (roundedCapacity < capacity) {
+        roundedCapacity <<= 1;
+    }
+    this->m_buffer.resize(roundedCapacity);
+    this->m_mask = roundedCapacity - 1;
+}
+
+std::pair<char *, size_t> SpscByteQueue::writeSpan() {
+    auto tail = this->m_tail.load(std::memory_order_relaxed);
+    auto head = this->m_head.load(std::memory_order_acquire);
+    auto freeBytes = this->m_buffer.size() - (tail - head);
+    auto physicalTail = tail & this->m_mask;
+    return std::make_pair(this->m_buffer.data() + physicalTail, std::min(freeBytes, this->m_buffer.size() - physicalTail));
+}
+
+void SpscByteQueue::commitWrite(size_t count) {
+    this->m_tail.store(this->m_tail.load(std::memory_order_relaxed) + count, std::memory_order_seq_cst);
+}
+
+size_t SpscByteQueue::push(const char *bytes, size_t length) {
+    size_t pushed{0};
+    while (pushed < length) {
+        auto span = this->writeSpan();
+        if (span.second == 0) {
+            break;
+        }
+        auto count = std::min(span.second, length - pushed);
+        memcpy(span.first, bytes + pushed, count);
+        this->commitWrite(count);
+        pushed += count;
+    }
+    return pushed;
+}
+
+size_t SpscByteQueue::pop(char *buffer, size_t maximum) {
+    auto head = this->m_head.load(std::memory_order_relaxed);
+    auto tail = this->m_tail.load(std::memory_order_seq_cst);
+    auto count = std::min(maximum, tail - head);
+    if (count == 0) {
+        return 0;
+    }
+    auto physicalHead = head & this->m_mask;
+    auto firstPart = std::min(count, this->m_buffer.size() - physicalHead);
+    memcpy(buffer, this->m_buffer.data() + physicalHead, firstPart);
+    memcpy(buffer + firstPart, this->m_buffer.data(), count - firstPart);
+    this->m_head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+void SpscByteQueue::clear() {
+    this->m_head.store(this->m_tail.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+size_t SpscByteQueue::size() const {
+    auto head = this->m_head.load(std::memory_order_acquire);
+    return this->m_tail.load(std::memory_order_seq_cst) - head;
+}
+
+size_t SpscByteQueue::capacity() const {
+    return this->m_buffer.size();
+}
+
+bool SpscByteQueue::empty() const {
+    return this->size() == 0;
+}
+
+} //namespace CppSerialPort
@@ -0,0 +1,412 @@
+#include <CppSerialPort/StreamBridge.hpp>
+#include <CppSerialPort/DescriptorWaiter.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using ErrorInformation::getLastError;
+using ErrorInformation::getErrorString;
+
+namespace {
+    //Puts a descriptor into non-blocking mode and puts the original flags back when the bridge stops
+    class NonBlockingScope {
+    public:
+        explicit NonBlockingScope(int fileDescriptor) :
+            m_fileDescriptor{fileDescriptor},
+            m_flags{fcntl(fileDescriptor, F_GETFL)}
+        {
+            if (this->m_flags != -1) {
+                fcntl(this->m_fileDescriptor, F_SETFL, this->m_flags | O_NONBLOCK);
+            }
+        }
+        NonBlockingScope(const NonBlockingScope &) = delete;
+        NonBlockingScope &operator=(const NonBlockingScope &) = delete;
+        ~NonBlockingScope() {
+            if (this->m_flags != -1) {
+                fcntl(this->m_fileDescriptor, F_SETFL, this->m_flags);
+            }
+        }
+
+    private:
+        int m_fileDescriptor;
+        int m_flags;
+    };
+
+    bool isSocket(int fileDescriptor) {
+        struct stat status{};
+        return (fstat(fileDescriptor, &status) == 0) && (S_ISSOCK(status.st_mode));
+    }
+
+    bool wouldBlock(int errorCode) {
+        return (errorCode == EAGAIN) || (errorCode == EWOULDBLOCK) || (errorCode == EINTR);
+    }
+}
+
+namespace CppSerialPort {
+
+const size_t StreamBridge::DEFAULT_CHUNK_SIZE{65536};
+
+struct StreamBridge::Pump {
+    Pump(IByteStream &sourceStream, IByteStream &destinationStream) :
+        source{&sourceStream},
+        destination{&destinationStream},
+        sourceDescriptor{sourceStream.fileDescriptor()},
+        destinationDescriptor{destinationStream.fileDescriptor()},
+        destinationIsSocket{isSocket(destinationStream.fileDescriptor())},
+        mode{TransferMode::Buffered},
+        pipeDescriptors{-1, -1},
+        pipeBytes{0},
+        splicedOut{false},
+        buffer{},
+        bufferStart{0},
+        bufferEnd{0},
+        sourceClosed{false},
+        pendingSince{},
+        bytes{0},
+        transfers{0},
+        lastLatency{0},
+        totalLatency{0},
+        maximumLatency{0}
+    {
+
+    }
+
+    ~Pump() {
+        for (auto fileDescriptor : this->pipeDescriptors) {
+            if (fileDescriptor != -1) {
+                close(fileDescriptor);
+            }
+        }
+    }
+
+    size_t pending() const {
+        return this->pipeBytes + (this->bufferEnd - this->bufferStart);
+    }
+
+    IByteStream *source;
+    IByteStream *destination;
+    int sourceDescriptor;
+    int destinationDescriptor;
+    bool destinationIsSocket;
+    TransferMode mode;
+    int pipeDescriptors[2];
+    size_t pipeBytes;
+    bool splicedOut;
+    std::vector<char> buffer;
+    size_t bufferStart;
+    size_t bufferEnd;
+    bool sourceClosed;
+    std::chrono::steady_clock::time_point pendingSince;
+    uint64_t bytes;
+    uint64_t transfers;
+    std::chrono::microseconds lastLatency;
+    std::chrono::microseconds totalLatency;
+    std::chrono::microseconds maximumLatency;
+};
+
+StreamBridge::StreamBridge(IByteStream &first, IByteStream &second) :
+    m_first{first},
+    m_second{second},
+    m_spliceEnabled{true},
+    m_chunkSize{DEFAULT_CHUNK_SIZE},
+    m_firstToSecond{nullptr},
+    m_secondToFirst{nullptr},
+    m_running{false},
+    m_wakeDescriptor{-1},
+    m_thread{},
+    m_statisticsMutex{},
+    m_error{},
+    m_startedAt{},
+    m_stoppedAt{}
+{
+    this->m_wakeDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (this->m_wakeDescriptor == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::StreamBridge::StreamBridge(IByteStream &, IByteStream &): eventfd(unsigned int, int) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+}
+
+StreamBridge::~StreamBridge() {
+    this->stop();
+    close(this->m_wakeDescriptor);
+}
+
+void StreamBridge::setSpliceEnabled(bool enabled) {
+    this->m_spliceEnabled = enabled;
+}
+
+bool StreamBridge::spliceEnabled() const {
+    return this->m_spliceEnabled;
+}
+
+void StreamBridge::setChunkSize(size_t chunkSize) {
+    if (chunkSize == 0) {
+        throw std::runtime_error("CppSerialPort::StreamBridge::setChunkSize(size_t): chunkSize cannot be 0");
+    }
+    this->m_chunkSize = chunkSize;
+}
+
+size_t StreamBridge::chunkSize() const {
+    return this->m_chunkSize;
+}
+
+void StreamBridge::run() {
+    if (this->m_running.exchange(true)) {
+        throw std::runtime_error("CppSerialPort::StreamBridge::run(): bridge is already running");
+    }
+    try {
+        this->pump();
+    } catch (std::exception &e) {
+        std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+        this->m_error = e.what();
+        this->m_stoppedAt = std::chrono::steady_clock::now();
+        this->m_running.store(false);
+        throw;
+    }
+    std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+    this->m_stoppedAt = std::chrono::steady_clock::now();
+    this->m_running.store(false);
+}
+
+void StreamBridge::start() {
+    if (this->m_thread.joinable()) {
+        this->m_thread.join();
+    }
+    this->m_thread = std::thread{[this]() {
+        try {
+            this->run();
+        } catch (std::exception &) {
+            //Already kept for error()
+        }
+    }};
+}
+
+void StreamBridge::stop() {
+    this->m_running.store(false);
+    uint64_t wake{1};
+    auto written = write(this->m_wakeDescriptor, &wake, sizeof(wake));
+    (void)written;
+    if ( (this->m_thread.joinable()) && (this->m_thread.get_id() != std::this_thread::get_id()) ) {
+        this->m_thread.join();
+    }
+}
+
+bool StreamBridge::isRunning() const {
+    return this->m_running.load();
+}
+
+std::string StreamBridge::error() const {
+    std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+    return this->m_error;
+}
+
+StreamBridge::DirectionStatistics StreamBridge::statistics(Direction direction) const {
+    std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+    DirectionStatistics returnValue{};
+    returnValue.mode = this->m_spliceEnabled ? TransferMode::Splice : TransferMode::Buffered;
+    const auto &pump = (direction == Direction::FirstToSecond) ? this->m_firstToSecond : this->m_secondToFirst;
+    if (!pump) {
+        return returnValue;
+    }
+    returnValue.mode = pump->mode;
+    returnValue.bytes = pump->bytes;
+    returnValue.transfers = pump->transfers;
+    returnValue.lastLatency = pump->lastLatency;
+    returnValue.maximumLatency = pump->maximumLatency;
+    returnValue.averageLatency = (pump->transfers == 0) ? std::chrono::microseconds{0} : std::chrono::microseconds{pump->totalLatency.count() / static_cast<long long>(pump->transfers)};
+    auto finishedAt = this->m_running.load() ? std::chrono::steady_clock::now() : this->m_stoppedAt;
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(finishedAt - this->m_startedAt).count();
+    returnValue.bytesPerSecond = (elapsed > 0.0) ? static_cast<double>(pump->bytes) / elapsed : 0.0;
+    return returnValue;
+}
+
+void StreamBridge::pump() {
+    if ( (this->m_first.fileDescriptor() < 0) || (this->m_second.fileDescriptor() < 0) ) {
+        throw std::runtime_error("CppSerialPort::StreamBridge::pump(): " + this->m_first.portName() + " and " + this->m_second.portName() + " must both be open");
+    }
+    uint64_t wake{0};
+    auto readBytes = read(this->m_wakeDescriptor, &wake, sizeof(wake));
+    (void)readBytes;
+    {
+        std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+        this->m_error.clear();
+        this->m_startedAt = std::chrono::steady_clock::now();
+        this->m_firstToSecond.reset(new Pump{this->m_first, this->m_second});
+        this->m_secondToFirst.reset(new Pump{this->m_second, this->m_first});
+    }
+    Pump *pumps[2]{this->m_firstToSecond.get(), this->m_secondToFirst.get()};
+    for (auto pump : pumps) {
+        //Whatever the source had already buffered has to go out first, and while the streams are still blocking
+        auto leftover = pump->source->readAvailable();
+        if (!leftover.empty()) {
+            pump->destination->write(leftover);
+            std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+            pump->bytes += leftover.size();
+        }
+        if (this->m_spliceEnabled) {
+            if (pipe2(pump->pipeDescriptors, O_CLOEXEC | O_NONBLOCK) == -1) {
+                auto errorCode = getLastError();
+                throw std::runtime_error("CppSerialPort::StreamBridge::pump(): pipe2(int *, int) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+            }
+            //Best effort: a larger pipe moves more per splice, but the size is capped by fs.pipe-max-size
+            fcntl(pump->pipeDescriptors[1], F_SETPIPE_SZ, static_cast<int>(this->m_chunkSize));
+            pump->mode = TransferMode::Splice;
+        } else {
+            pump->buffer.resize(this->m_chunkSize);
+        }
+    }
+    NonBlockingScope firstScope{this->m_first.fileDescriptor()};
+    NonBlockingScope secondScope{this->m_second.fileDescriptor()};
+
+    DescriptorWaiter::descriptor_t descriptors[3]{};
+    short events[3]{};
+    short returnedEvents[3]{};
+    while (this->m_running.load()) {
+        descriptors[0] = this->m_wakeDescriptor;
+        events[0] = POLLIN;
+        for (size_t i = 0; i < 2; i++) {
+            auto pump = pumps[i];
+            if ( (pump->sourceClosed) && (pump->pending() == 0) ) {
+                //One side has ended and everything it sent has been delivered
+                return;
+            }
+            if (pump->pending() != 0) {
+                descriptors[i + 1] = pump->destinationDescriptor;
+                events[i + 1] = POLLOUT;
+            } else {
+                descriptors[i + 1] = pump->sourceDescriptor;
+                events[i + 1] = POLLIN;
+            }
+        }
+        if (DescriptorWaiter::waitForEach(descriptors, events, returnedEvents, 3, std::chrono::steady_clock::now() + std::chrono::hours{1}) == 0) {
+            continue;
+        }
+        auto readyAt = std::chrono::steady_clock::now();
+        if (returnedEvents[0] != 0) {
+            readBytes = read(this->m_wakeDescriptor, &wake, sizeof(wake));
+            (void)readBytes;
+        }
+        for (size_t i = 0; i < 2; i++) {
+            if (returnedEvents[i + 1] == 0) {
+                continue;
+            }
+            if (returnedEvents[i + 1] & POLLNVAL) {
+                throw std::runtime_error("CppSerialPort::StreamBridge::pump(): " + pumps[i]->source->portName() + " or " + pumps[i]->destination->portName() + " was closed while bridged");
+            }
+            if (events[i + 1] == POLLOUT) {
+                this->transferOut(*pumps[i]);
+            } else {
+                this->transferIn(*pumps[i], readyAt);
+            }
+        }
+    }
+}
+
+void StreamBridge::transferIn(Pump &pump, std::chrono::steady_clock::time_point readyAt) {
+    ssize_t result{0};
+    if (pump.mode == TransferMode::Splice) {
+        result = splice(pump.sourceDescriptor, nullptr, pump.pipeDescriptors[1], nullptr, this->m_chunkSize, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if ( (result == -1) && (getLastError() == EINVAL) ) {
+            //The source has no splice_read (a tty, for example), so this direction goes through a buffer instead
+            this->fallBackToBuffered(pump);
+        }
+    }
+    if (pump.mode == TransferMode::Buffered) {
+        pump.bufferStart = 0;
+        pump.bufferEnd = 0;
+        result = read(pump.sourceDescriptor, pump.buffer.data(), pump.buffer.size());
+    }
+    if (result == -1) {
+        auto errorCode = getLastError();
+        if (wouldBlock(errorCode)) {
+            return;
+        }
+        throw std::runtime_error("CppSerialPort::StreamBridge::transferIn(Pump &, std::chrono::steady_clock::time_point): reading from " + pump.source->portName() + " failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    if (result == 0) {
+        pump.sourceClosed = true;
+        return;
+    }
+    pump.pendingSince = readyAt;
+    if (pump.mode == TransferMode::Splice) {
+        pump.pipeBytes = static_cast<size_t>(result);
+    } else {
+        pump.bufferEnd = static_cast<size_t>(result);
+    }
+    //The destination is usually writable already, which saves a trip through poll()
+    this->transferOut(pump);
+}
+
+void StreamBridge::transferOut(Pump &pump) {
+    ssize_t result{0};
+    if (pump.mode == TransferMode::Splice) {
+        result = splice(pump.pipeDescriptors[0], nullptr, pump.destinationDescriptor, nullptr, pump.pipeBytes, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if ( (result == -1) && (getLastError() == EINVAL) && (!pump.splicedOut) ) {
+            this->fallBackToBuffered(pump);
+        }
+    }
+    if (pump.mode == TransferMode::Buffered) {
+        auto data = pump.buffer.data() + pump.bufferStart;
+        auto length = pump.bufferEnd - pump.bufferStart;
+        result = pump.destinationIsSocket ? send(pump.destinationDescriptor, data, length, MSG_NOSIGNAL) : write(pump.destinationDescriptor, data, length);
+    }
+    if (result == -1) {
+        auto errorCode = getLastError();
+        if (wouldBlock(errorCode)) {
+            return;
+        }
+        throw std::runtime_error("CppSerialPort::StreamBridge::transferOut(Pump &): writing to " + pump.destination->portName() + " failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    if (pump.mode == TransferMode::Splice) {
+        pump.splicedOut = true;
+        pump.pipeBytes -= static_cast<size_t>(result);
+    } else {
+        pump.bufferStart += static_cast<size_t>(result);
+    }
+    std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+    pump.bytes += static_cast<uint64_t>(result);
+    if (pump.pending() == 0) {
+        pump.transfers++;
+        pump.lastLatency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pump.pendingSince);
+        pump.totalLatency += pump.lastLatency;
+        pump.maximumLatency = std::max(pump.maximumLatency, pump.lastLatency);
+    }
+}
+
+void StreamBridge::fallBackToBuffered(Pump &pump) {
+    std::lock_guard<std::mutex> statisticsLock{this->m_statisticsMutex};
+    pump.buffer.resize(std::max(this->m_chunkSize, pump.pipeBytes));
+    pump.bufferStart = 0;
+    pump.bufferEnd = 0;
+    //Anything already spliced in is pulled back out of the pipe, so nothing is lost or reordered
+    while (pump.pipeBytes > 0) {
+        auto result = read(pump.pipeDescriptors[0], pump.buffer.data() + pump.bufferEnd, pump.pipeBytes);
+        if (result <= 0) {
+            break;
+        }
+        pump.bufferEnd += static_cast<size_t>(result);
+        pump.pipeBytes -= static_cast<size_t>(result);
+    }
+    this->closePipe(pump);
+    pump.mode = TransferMode::Buffered;
+}
+
+void StreamBridge::closePipe(Pump &pump) {
+    for (auto &fileDescriptor : pump.pipeDescriptors) {
+        if (fileDescriptor != -1) {
+            close(fileDescriptor);
+            fileDescriptor = -1;
+        }
+    }
+}
+
+} //namespace CppSerialPort
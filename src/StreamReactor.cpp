@@ -0,0 +1,654 @@
+#include <CppSerialPort/StreamReactor.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#if defined(CPPSERIALPORT_HAS_IO_URING)
+#    include <CppSerialPort/IoUring.hpp>
+#    include <poll.h>
+#endif //defined(CPPSERIALPORT_HAS_IO_URING)
+
+using ErrorInformation::getLastError;
+using ErrorInformation::getErrorString;
+
+namespace {
+    //io_uring user data: generation in the high word, then the slot, then the operation in the low two bits
+    enum RingOperation : uint64_t {
+        RING_POLL = 0,
+        RING_READ = 1,
+        RING_WRITE = 2
+    };
+    const uint64_t WAKE_USER_DATA{~static_cast<uint64_t>(1)};
+    const uint64_t CANCEL_USER_DATA{~static_cast<uint64_t>(2)};
+
+    uint64_t ringUserData(uint32_t generation, unsigned slot, RingOperation operation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(slot) << 2) | operation;
+    }
+}
+
+namespace CppSerialPort {
+
+StreamReactor::StreamReactor(Backend backend) :
+    m_backend{backend},
+    m_epollDescriptor{-1},
+    m_wakeDescriptor{-1},
+    m_running{false},
+    m_registrationMutex{},
+    m_registrations{},
+    m_ring{nullptr},
+    m_ringBuffers{},
+    m_fixedBuffers{false},
+    m_slots{},
+    m_slotOperations{},
+    m_slotGenerations{},
+    m_armQueue{},
+    m_releaseQueue{},
+    m_writeQueue{},
+    m_pollingThread{}
+{
+    this->m_wakeDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (this->m_wakeDescriptor == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::StreamReactor::StreamReactor(Backend): eventfd(unsigned int, int) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    try {
+        if (this->m_backend == Backend::Automatic) {
+            this->m_backend = Backend::IoUring;
+            try {
+                this->setupIoUring();
+            } catch (std::exception &) {
+                //Too old a kernel, io_uring disabled by sysctl or seccomp, or built without it
+                this->m_ring.reset();
+                this->m_ringBuffers = std::vector<char>{};
+                this->m_backend = Backend::Epoll;
+                this->setupEpoll();
+            }
+        } else if (this->m_backend == Backend::IoUring) {
+            this->setupIoUring();
+        } else {
+            this->setupEpoll();
+        }
+    } catch (std::exception &) {
+        if (this->m_epollDescriptor != -1) {
+            close(this->m_epollDescriptor);
+        }
+        close(this->m_wakeDescriptor);
+        throw;
+    }
+}
+
+StreamReactor::~StreamReactor() {
+    //The ring goes first, since it still holds the wakeup descriptor and every registered stream's file
+    this->m_ring.reset();
+    close(this->m_wakeDescriptor);
+    if (this->m_epollDescriptor != -1) {
+        close(this->m_epollDescriptor);
+    }
+}
+
+void StreamReactor::setupEpoll() {
+    this->m_epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    if (this->m_epollDescriptor == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::StreamReactor::setupEpoll(): epoll_create1(int) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = this->m_wakeDescriptor;
+    if (epoll_ctl(this->m_epollDescriptor, EPOLL_CTL_ADD, this->m_wakeDescriptor, &event) == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::StreamReactor::setupEpoll(): epoll_ctl(int, int, int, epoll_event *) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+}
+
+StreamReactor::Backend StreamReactor::backend() const {
+    return this->m_backend;
+}
+
+void StreamReactor::add(IByteStream &stream, const ReadCallback &onRead, const ErrorCallback &onError) {
+    auto fileDescriptor = stream.fileDescriptor();
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("CppSerialPort::StreamReactor::add(IByteStream &, const ReadCallback &, const ErrorCallback &): stream " + stream.portName() + " has no file descriptor (is it open?)");
+    }
+    if (!onRead) {
+        throw std::runtime_error("CppSerialPort::StreamReactor::add(IByteStream &, const ReadCallback &, const ErrorCallback &): onRead callback cannot be empty");
+    }
+    auto registration = std::make_shared<Registration>();
+    registration->stream = &stream;
+    registration->onRead = onRead;
+    registration->onError = onError;
+    registration->server = nullptr;
+    this->addRegistration(fileDescriptor, registration, stream.portName());
+}
+
+void StreamReactor::addServer(TcpServer &server, const AcceptCallback &onAccept) {
+    auto fileDescriptor = server.fileDescriptor();
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("CppSerialPort::StreamReactor::addServer(TcpServer &, const AcceptCallback &): server on port " + std::to_string(server.portNumber()) + " has no file descriptor (is it listening?)");
+    }
+    if (!onAccept) {
+        throw std::runtime_error("CppSerialPort::StreamReactor::addServer(TcpServer &, const AcceptCallback &): onAccept callback cannot be empty");
+    }
+    auto registration = std::make_shared<Registration>();
+    registration->stream = nullptr;
+    registration->server = &server;
+    registration->onAccept = onAccept;
+    this->addRegistration(fileDescriptor, registration, "server on port " + std::to_string(server.portNumber()));
+}
+
+void StreamReactor::addRegistration(int fileDescriptor, const std::shared_ptr<Registration> &registration, const std::string &name) {
+    registration->fileDescriptor = fileDescriptor;
+    registration->slot = 0;
+    registration->generation = 0;
+    registration->pollError = 0;
+    registration->writeOffset = 0;
+    registration->writing = false;
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        auto existing = this->m_registrations.find(fileDescriptor);
+        if (this->m_backend == Backend::IoUring) {
+            unsigned slot{0};
+            while ( (slot < this->m_slots.size()) && ( (this->m_slots[slot]) || (this->m_slotOperations[slot] != 0) ) ) {
+                slot++;
+            }
+            if (slot == this->m_slots.size()) {
+                throw std::runtime_error("CppSerialPort::StreamReactor::addRegistration(int, const std::shared_ptr<Registration> &, const std::string &): no io_uring slot left for " + name + " (at most " + std::to_string(MAXIMUM_URING_STREAMS) + " streams)");
+            }
+            if (existing != this->m_registrations.end()) {
+                this->m_releaseQueue.push_back(existing->second);
+            }
+            registration->slot = slot;
+            registration->generation = ++this->m_slotGenerations[slot];
+            this->m_slots[slot] = registration;
+            this->m_armQueue.push_back(registration);
+        } else {
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+            event.data.fd = fileDescriptor;
+            auto operation = (existing == this->m_registrations.end()) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+            if (epoll_ctl(this->m_epollDescriptor, operation, fileDescriptor, &event) == -1) {
+                auto errorCode = getLastError();
+                throw std::runtime_error("CppSerialPort::StreamReactor::addRegistration(int, const std::shared_ptr<Registration> &, const std::string &): epoll_ctl(int, int, int, epoll_event *) failed for " + name + ", error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+            }
+        }
+        this->m_registrations[fileDescriptor] = registration;
+    }
+    if (this->m_backend == Backend::IoUring) {
+        this->wakeFromOtherThread();
+    }
+}
+
+bool StreamReactor::remove(IByteStream &stream) {
+    return this->removeRegistration([&stream](const Registration &registration) { return registration.stream == &stream; });
+}
+
+bool StreamReactor::remove(TcpServer &server) {
+    return this->removeRegistration([&server](const Registration &registration) { return registration.server == &server; });
+}
+
+bool StreamReactor::removeRegistration(const std::function<bool(const Registration &)> &matches) {
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        auto iter = this->m_registrations.begin();
+        while ( (iter != this->m_registrations.end()) && (!matches(*iter->second)) ) {
+            iter++;
+        }
+        if (iter == this->m_registrations.end()) {
+            return false;
+        }
+        if (this->m_backend == Backend::IoUring) {
+            this->m_releaseQueue.push_back(iter->second);
+        } else {
+            //The descriptor may already be closed (and so already dropped from the epoll set), so errors are ignored
+            epoll_ctl(this->m_epollDescriptor, EPOLL_CTL_DEL, iter->first, nullptr);
+        }
+        this->m_registrations.erase(iter);
+    }
+    if (this->m_backend == Backend::IoUring) {
+        this->wakeFromOtherThread();
+    }
+    return true;
+}
+
+bool StreamReactor::contains(const IByteStream &stream) const {
+    return this->findRegistration(stream) != nullptr;
+}
+
+size_t StreamReactor::size() const {
+    std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+    return this->m_registrations.size();
+}
+
+void StreamReactor::queueWrite(IByteStream &stream, const ByteArray &bytes) {
+    auto registration = this->findRegistration(stream);
+    if (!registration) {
+        throw std::runtime_error("CppSerialPort::StreamReactor::queueWrite(IByteStream &, const ByteArray &): stream " + stream.portName() + " has not been added to this reactor");
+    }
+    if (bytes.empty()) {
+        return;
+    }
+    if (this->m_backend != Backend::IoUring) {
+        try {
+            stream.write(bytes);
+        } catch (std::exception &e) {
+            this->fail(registration, registration->fileDescriptor, e);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        registration->pendingWrites.push_back(bytes);
+        if (!registration->writing) {
+            this->m_writeQueue.push_back(registration);
+        }
+    }
+    this->wakeFromOtherThread();
+}
+
+size_t StreamReactor::poll(int timeout) {
+    size_t serviced{0};
+#if defined(CPPSERIALPORT_HAS_IO_URING)
+    if (this->m_backend == Backend::IoUring) {
+        this->m_pollingThread.store(std::this_thread::get_id());
+        this->flushRequests();
+        this->m_ring->submitAndWait( (timeout == 0) ? 0 : 1, timeout);
+        this->m_ring->reapCompletions([this, &serviced](const io_uring_cqe &completion) {
+            if (this->complete(completion.user_data, completion.res)) {
+                serviced++;
+            }
+        });
+        //Whatever the callbacks asked for is queued now and goes out with the next submission
+        this->flushRequests();
+        return serviced;
+    }
+#endif //defined(CPPSERIALPORT_HAS_IO_URING)
+    epoll_event events[MAXIMUM_EVENTS_PER_POLL];
+    auto eventCount = epoll_wait(this->m_epollDescriptor, events, MAXIMUM_EVENTS_PER_POLL, timeout);
+    if (eventCount == -1) {
+        auto errorCode = getLastError();
+        if (errorCode == EINTR) {
+            return 0;
+        }
+        throw std::runtime_error("CppSerialPort::StreamReactor::poll(int): epoll_wait(int, epoll_event *, int, int) failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+    }
+    for (int i = 0; i < eventCount; i++) {
+        if (events[i].data.fd == this->m_wakeDescriptor) {
+            this->clearWakeup();
+            continue;
+        }
+        this->dispatch(events[i].data.fd, events[i].events);
+        serviced++;
+    }
+    return serviced;
+}
+
+void StreamReactor::run() {
+    this->m_running.store(true);
+    while (this->m_running.load()) {
+        this->poll(-1);
+    }
+}
+
+void StreamReactor::stop() {
+    this->m_running.store(false);
+    uint64_t wake{1};
+    auto written = write(this->m_wakeDescriptor, &wake, sizeof(wake));
+    (void)written;
+}
+
+bool StreamReactor::isRunning() const {
+    return this->m_running.load();
+}
+
+std::shared_ptr<StreamReactor::Registration> StreamReactor::findRegistration(int fileDescriptor) const {
+    std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+    auto found = this->m_registrations.find(fileDescriptor);
+    return (found == this->m_registrations.end()) ? nullptr : found->second;
+}
+
+std::shared_ptr<StreamReactor::Registration> StreamReactor::findRegistration(const IByteStream &stream) const {
+    std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+    for (const auto &it : this->m_registrations) {
+        if (it.second->stream == &stream) {
+            return it.second;
+        }
+    }
+    return nullptr;
+}
+
+bool StreamReactor::isRegistered(const std::shared_ptr<Registration> &registration) const {
+    return this->findRegistration(registration->fileDescriptor) == registration;
+}
+
+void StreamReactor::dispatch(int fileDescriptor, uint32_t events) {
+    //Callbacks run without the lock held so they are free to add() or remove() streams
+    auto registration = this->findRegistration(fileDescriptor);
+    if (!registration) {
+        return;
+    }
+    if (registration->server) {
+        for (auto &socket : registration->server->acceptPending()) {
+            registration->onAccept(*registration->server, std::move(socket));
+        }
+        return;
+    }
+    auto &stream = *registration->stream;
+    try {
+        //Edge triggered, so everything pending must be taken now or no further event arrives for it
+        while (true) {
+            auto bytes = stream.readAvailable();
+            if (bytes.empty()) {
+                break;
+            }
+            registration->onRead(stream, bytes);
+            if (!this->isRegistered(registration)) {
+                return;
+            }
+        }
+        if (events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            this->hangup(registration);
+        }
+    } catch (std::exception &e) {
+        this->fail(registration, fileDescriptor, e);
+    }
+}
+
+void StreamReactor::hangup(const std::shared_ptr<Registration> &registration) {
+    //Nothing left to drain, so a blocking read reaches end of stream and surfaces the stream's own disconnect exception
+    auto &stream = *registration->stream;
+    char lastByte{0};
+    bool timeout{false};
+    if (stream.read(&lastByte, 1, &timeout) == 1) {
+        registration->onRead(stream, ByteArray{lastByte});
+        return;
+    }
+    throw std::runtime_error("CppSerialPort::StreamReactor::hangup(const std::shared_ptr<Registration> &): " + stream.portName() + " reported a hangup");
+}
+
+void StreamReactor::fail(const std::shared_ptr<Registration> &registration, int fileDescriptor, const std::exception &exception) {
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        auto found = this->m_registrations.find(fileDescriptor);
+        if ( (found != this->m_registrations.end()) && (found->second == registration) ) {
+            if (this->m_backend == Backend::IoUring) {
+                this->m_releaseQueue.push_back(registration);
+            } else {
+                epoll_ctl(this->m_epollDescriptor, EPOLL_CTL_DEL, fileDescriptor, nullptr);
+            }
+            this->m_registrations.erase(found);
+        }
+    }
+    if (registration->onError) {
+        registration->onError(*registration->stream, exception);
+    }
+}
+
+void StreamReactor::clearWakeup() {
+    uint64_t wake{0};
+    auto readBytes = read(this->m_wakeDescriptor, &wake, sizeof(wake));
+    (void)readBytes;
+}
+
+void StreamReactor::wakeFromOtherThread() {
+    //The polling thread picks up its own requests on the way out of poll(), so only other threads need to interrupt the wait
+    if (this->m_pollingThread.load() == std::this_thread::get_id()) {
+        return;
+    }
+    uint64_t wake{1};
+    auto written = write(this->m_wakeDescriptor, &wake, sizeof(wake));
+    (void)written;
+}
+
+#if defined(CPPSERIALPORT_HAS_IO_URING)
+
+void StreamReactor::setupIoUring() {
+    this->m_ring.reset(new IoUring{URING_QUEUE_DEPTH});
+    //Sparse table: slots get a descriptor as streams are added
+    std::vector<int> files(MAXIMUM_URING_STREAMS, -1);
+    this->m_ring->registerFiles(files.data(), static_cast<unsigned>(files.size()));
+    this->m_ringBuffers.resize(MAXIMUM_URING_STREAMS * URING_READ_SIZE);
+    iovec buffers{};
+    buffers.iov_base = this->m_ringBuffers.data();
+    buffers.iov_len = this->m_ringBuffers.size();
+    try {
+        this->m_ring->registerBuffers(&buffers, 1);
+        this->m_fixedBuffers = true;
+    } catch (std::exception &) {
+        //Usually RLIMIT_MEMLOCK, and plain reads into the same memory still work
+        this->m_fixedBuffers = false;
+    }
+    this->m_slots.resize(MAXIMUM_URING_STREAMS);
+    this->m_slotOperations.resize(MAXIMUM_URING_STREAMS, 0);
+    this->m_slotGenerations.resize(MAXIMUM_URING_STREAMS, 0);
+    this->armWakeup();
+}
+
+io_uring_sqe *StreamReactor::nextSubmission(unsigned reserve) {
+    if (this->m_ring->spaceLeft() < reserve) {
+        this->m_ring->submitAndWait(0, 0);
+    }
+    auto submission = this->m_ring->nextSubmission();
+    if (submission == nullptr) {
+        throw std::runtime_error("CppSerialPort::StreamReactor::nextSubmission(unsigned): io_uring submission queue is full");
+    }
+    return submission;
+}
+
+void StreamReactor::flushRequests() {
+    std::vector<std::shared_ptr<Registration>> releases{};
+    std::vector<std::shared_ptr<Registration>> arms{};
+    std::vector<std::shared_ptr<Registration>> writes{};
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        releases.swap(this->m_releaseQueue);
+        arms.swap(this->m_armQueue);
+        writes.swap(this->m_writeQueue);
+    }
+    for (auto &registration : releases) {
+        this->releaseRegistration(registration);
+    }
+    for (auto &registration : arms) {
+        if (!this->isRegistered(registration)) {
+            continue;
+        }
+        this->m_ring->updateFile(registration->slot, registration->fileDescriptor);
+        if (registration->stream) {
+            //Anything the stream buffered before it was added would otherwise wait for the next read completion
+            try {
+                auto bytes = registration->stream->readAvailable();
+                if (!bytes.empty()) {
+                    registration->onRead(*registration->stream, bytes);
+                }
+            } catch (std::exception &e) {
+                this->fail(registration, registration->fileDescriptor, e);
+                continue;
+            }
+            if (!this->isRegistered(registration)) {
+                continue;
+            }
+        }
+        this->armRegistration(registration);
+    }
+    for (auto &registration : writes) {
+        if (this->isRegistered(registration)) {
+            this->submitWrite(registration);
+        }
+    }
+}
+
+void StreamReactor::armRegistration(const std::shared_ptr<Registration> &registration) {
+    auto slot = registration->slot;
+    auto poll = this->nextSubmission(2);
+    poll->opcode = IORING_OP_POLL_ADD;
+    poll->flags = IOSQE_FIXED_FILE;
+    poll->fd = static_cast<int>(slot);
+    poll->poll_events = POLLIN;
+    poll->user_data = ringUserData(registration->generation, slot, RING_POLL);
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        this->m_slotOperations[slot] += (registration->server) ? 1 : 2;
+    }
+    if (registration->server) {
+        return;
+    }
+    //Linked so the read only runs once there is data: a serial port set up for non-blocking reads would otherwise return 0 at once
+    poll->flags |= IOSQE_IO_LINK;
+    auto read = this->nextSubmission();
+    read->opcode = this->m_fixedBuffers ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    read->flags = IOSQE_FIXED_FILE;
+    read->fd = static_cast<int>(slot);
+    read->addr = reinterpret_cast<uint64_t>(this->m_ringBuffers.data() + slot * URING_READ_SIZE);
+    read->len = static_cast<uint32_t>(URING_READ_SIZE);
+    read->off = ~static_cast<uint64_t>(0);
+    read->buf_index = 0;
+    read->user_data = ringUserData(registration->generation, slot, RING_READ);
+}
+
+void StreamReactor::releaseRegistration(const std::shared_ptr<Registration> &registration) {
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        if (this->m_slots[registration->slot] != registration) {
+            return;
+        }
+        this->m_slots[registration->slot].reset();
+    }
+    //Cancelling the poll also cancels the read linked to it, and the slot is reused only once both have completed
+    for (auto operation : {RING_POLL, RING_WRITE}) {
+        auto cancel = this->nextSubmission();
+        cancel->opcode = IORING_OP_ASYNC_CANCEL;
+        cancel->fd = -1;
+        cancel->addr = ringUserData(registration->generation, registration->slot, operation);
+        cancel->user_data = CANCEL_USER_DATA;
+    }
+    this->m_ring->updateFile(registration->slot, -1);
+}
+
+void StreamReactor::submitWrite(const std::shared_ptr<Registration> &registration) {
+    const ByteArray *bytes{nullptr};
+    size_t offset{0};
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        if ( (registration->writing) || (registration->pendingWrites.empty()) ) {
+            return;
+        }
+        registration->writing = true;
+        bytes = &registration->pendingWrites.front();
+        offset = registration->writeOffset;
+        this->m_slotOperations[registration->slot]++;
+    }
+    //The deque never moves its elements, so the front stays put until its write completes
+    auto write = this->nextSubmission();
+    write->opcode = IORING_OP_WRITE;
+    write->flags = IOSQE_FIXED_FILE;
+    write->fd = static_cast<int>(registration->slot);
+    write->addr = reinterpret_cast<uint64_t>(bytes->data() + offset);
+    write->len = static_cast<uint32_t>(bytes->size() - offset);
+    write->off = ~static_cast<uint64_t>(0);
+    write->user_data = ringUserData(registration->generation, registration->slot, RING_WRITE);
+}
+
+void StreamReactor::armWakeup() {
+    auto poll = this->nextSubmission();
+    poll->opcode = IORING_OP_POLL_ADD;
+    poll->fd = this->m_wakeDescriptor;
+    poll->poll_events = POLLIN;
+    poll->user_data = WAKE_USER_DATA;
+}
+
+bool StreamReactor::complete(uint64_t userData, int32_t result) {
+    if (userData == CANCEL_USER_DATA) {
+        return false;
+    }
+    if (userData == WAKE_USER_DATA) {
+        this->clearWakeup();
+        this->armWakeup();
+        return false;
+    }
+    auto generation = static_cast<uint32_t>(userData >> 32);
+    auto slot = static_cast<unsigned>((userData & 0xFFFFFFFF) >> 2);
+    auto operation = static_cast<RingOperation>(userData & 3);
+    std::shared_ptr<Registration> registration{nullptr};
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        this->m_slotOperations[slot]--;
+        registration = this->m_slots[slot];
+        if ( (!registration) || (registration->generation != generation) ) {
+            return false;
+        }
+        if (operation == RING_WRITE) {
+            registration->writing = false;
+        }
+    }
+    //Still queued for release by remove() from another thread
+    if (!this->isRegistered(registration)) {
+        return false;
+    }
+
+    if (registration->server) {
+        for (auto &socket : registration->server->acceptPending()) {
+            registration->onAccept(*registration->server, std::move(socket));
+        }
+        if (this->isRegistered(registration)) {
+            this->armRegistration(registration);
+        }
+        return true;
+    }
+
+    auto &stream = *registration->stream;
+    try {
+        if (operation == RING_POLL) {
+            if (result < 0) {
+                //The linked read completes as cancelled, and reports this instead
+                registration->pollError = -result;
+            }
+            return false;
+        }
+        if (operation == RING_WRITE) {
+            if ( (result == -EAGAIN) || (result == -EINTR) ) {
+                this->submitWrite(registration);
+                return false;
+            }
+            if (result < 0) {
+                throw std::runtime_error("CppSerialPort::StreamReactor::complete(uint64_t, int32_t): write to " + stream.portName() + " failed, error code " + std::to_string(-result) + " (" + getErrorString(-result) + ")");
+            }
+            {
+                std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+                registration->writeOffset += static_cast<size_t>(result);
+                if (registration->writeOffset >= registration->pendingWrites.front().size()) {
+                    registration->pendingWrites.pop_front();
+                    registration->writeOffset = 0;
+                }
+            }
+            this->submitWrite(registration);
+            return false;
+        }
+        if (result > 0) {
+            registration->onRead(stream, ByteArray{this->m_ringBuffers.data() + slot * URING_READ_SIZE, static_cast<size_t>(result)});
+        } else if (result == 0) {
+            this->hangup(registration);
+        } else if ( (result != -EAGAIN) && (result != -EINTR) ) {
+            auto errorCode = ( (result == -ECANCELED) && (registration->pollError != 0) ) ? registration->pollError : -result;
+            throw std::runtime_error("CppSerialPort::StreamReactor::complete(uint64_t, int32_t): read from " + stream.portName() + " failed, error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ")");
+        }
+        if (this->isRegistered(registration)) {
+            this->armRegistration(registration);
+        }
+    } catch (std::exception &e) {
+        this->fail(registration, registration->fileDescriptor, e);
+    }
+    return true;
+}
+
+#else
+
+void StreamReactor::setupIoUring() {
+    throw std::runtime_error("CppSerialPort::StreamReactor::setupIoUring(): CppSerialPort was built without io_uring support");
+}
+
+#endif //defined(CPPSERIALPORT_HAS_IO_URING)
+
+} //namespace CppSerialPort
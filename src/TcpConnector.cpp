@@ -0,0 +1,290 @@
+#include <CppSerialPort/TcpConnector.hpp>
+#include <CppSerialPort/DescriptorWaiter.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#if defined(_WIN32)
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+     using getsockopt_t = char;
+#else
+#    include <unistd.h>
+#    include <fcntl.h>
+#    include <poll.h>
+#    define INVALID_SOCKET (-1)
+     using getsockopt_t = int;
+#endif //defined(_WIN32)
+
+#include <algorithm>
+#include <stdexcept>
+
+using NetworkErrorInformation::getLastError;
+using NetworkErrorInformation::getErrorString;
+
+namespace {
+    void closeSocket(socket_t socketDescriptor) {
+#if defined(_WIN32)
+        closesocket(socketDescriptor);
+#else
+        close(socketDescriptor);
+#endif //defined(_WIN32)
+    }
+
+    bool setBlocking(socket_t socketDescriptor, bool blocking) {
+#if defined(_WIN32)
+        unsigned long mode{blocking ? 0UL : 1UL};
+        return (ioctlsocket(socketDescriptor, FIONBIO, &mode) == 0);
+#else
+        auto flags = fcntl(socketDescriptor, F_GETFL, 0);
+        return ( (flags != -1) && (fcntl(socketDescriptor, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK)) != -1) );
+#endif //defined(_WIN32)
+    }
+
+    bool isInProgress(int errorCode) {
+#if defined(_WIN32)
+        return (errorCode == WSAEWOULDBLOCK);
+#else
+        return ( (errorCode == EINPROGRESS) || (errorCode == EINTR) );
+#endif //defined(_WIN32)
+    }
+
+    std::string describeAddress(const CppSerialPort::ResolvedAddress &address) {
+        char hostName[NI_MAXHOST];
+        char serviceName[NI_MAXSERV];
+        if (getnameinfo(reinterpret_cast<const sockaddr *>(&address.address), address.addressLength, hostName, sizeof(hostName), serviceName, sizeof(serviceName), NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+            return "<unknown address>";
+        }
+        return (address.family == AF_INET6) ? ('[' + std::string{hostName} + "]:" + serviceName) : (std::string{hostName} + ':' + serviceName);
+    }
+}
+
+namespace CppSerialPort {
+
+//RFC 8305 section 5 recommends 250ms
+const std::chrono::milliseconds TcpConnector::DEFAULT_ATTEMPT_DELAY{250};
+
+TcpConnector::TcpConnector(const std::vector<ResolvedAddress> &addresses, std::chrono::steady_clock::time_point deadline, const SocketOptions &socketOptions, std::chrono::milliseconds attemptDelay) :
+    m_addresses{interleave(addresses)},
+    m_deadline{deadline},
+    m_socketOptions{socketOptions},
+    m_attemptDelay{attemptDelay},
+    m_attempts{},
+    m_nextAddress{0},
+    m_nextAttemptAt{std::chrono::steady_clock::now()},
+    m_state{State::Connecting},
+    m_error{""},
+    m_connectedDescriptor{INVALID_SOCKET},
+    m_connectedAddress{0}
+{
+    if (this->m_addresses.empty()) {
+        this->fail("no addresses to connect to");
+    }
+}
+
+TcpConnector::~TcpConnector() {
+    this->closeAttempts();
+    if (this->m_connectedDescriptor != INVALID_SOCKET) {
+        closeSocket(this->m_connectedDescriptor);
+    }
+}
+
+std::vector<ResolvedAddress> TcpConnector::interleave(const std::vector<ResolvedAddress> &addresses) {
+    //Alternate families, starting with whichever the resolver preferred (RFC 8305 section 4)
+    if (addresses.empty()) {
+        return addresses;
+    }
+    auto preferredFamily = addresses.front().family;
+    std::vector<ResolvedAddress> preferred{};
+    std::vector<ResolvedAddress> others{};
+    for (const auto &address : addresses) {
+        (address.family == preferredFamily ? preferred : others).push_back(address);
+    }
+    std::vector<ResolvedAddress> interleaved{};
+    interleaved.reserve(addresses.size());
+    for (size_t i = 0; i < std::max(preferred.size(), others.size()); i++) {
+        if (i < preferred.size()) {
+            interleaved.push_back(preferred[i]);
+        }
+        if (i < others.size()) {
+            interleaved.push_back(others[i]);
+        }
+    }
+    return interleaved;
+}
+
+TcpConnector::State TcpConnector::advance() {
+    if (this->m_state != State::Connecting) {
+        return this->m_state;
+    }
+    //Collect attempts that have finished, one way or the other
+    for (size_t i = 0; i < this->m_attempts.size(); ) {
+        if (DescriptorWaiter::wait(this->m_attempts[i].socketDescriptor, POLLOUT, std::chrono::steady_clock::time_point{}) == 0) {
+            i++;
+            continue;
+        }
+        int socketError{0};
+        socklen_t socketErrorLength{sizeof(socketError)};
+        if (getsockopt(this->m_attempts[i].socketDescriptor, SOL_SOCKET, SO_ERROR, reinterpret_cast<getsockopt_t *>(&socketError), &socketErrorLength) != 0) {
+            socketError = getLastError();
+        }
+        if (socketError == 0) {
+            this->finish(i);
+            return this->m_state;
+        }
+        this->m_error = describeAddress(this->m_addresses[this->m_attempts[i].addressIndex]) + ": error code " + std::to_string(socketError) + " (" + getErrorString(socketError) + ')';
+        closeSocket(this->m_attempts[i].socketDescriptor);
+        this->m_attempts.erase(this->m_attempts.begin() + static_cast<std::ptrdiff_t>(i));
+        //A failure frees the next attempt to start right away instead of waiting out the delay
+        this->m_nextAttemptAt = std::chrono::steady_clock::now();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now >= this->m_deadline) {
+        this->fail("timed out" + (this->m_error.empty() ? std::string{""} : (", last error: " + this->m_error)));
+        return this->m_state;
+    }
+    while ( (this->m_nextAddress < this->m_addresses.size()) && ( (now >= this->m_nextAttemptAt) || (this->m_attempts.empty()) ) ) {
+        auto started = this->startAttempt(this->m_nextAddress++);
+        if (this->m_state != State::Connecting) {
+            return this->m_state;
+        }
+        if (started) {
+            this->m_nextAttemptAt = now + this->m_attemptDelay;
+            break;
+        }
+    }
+    if ( (this->m_attempts.empty()) && (this->m_nextAddress >= this->m_addresses.size()) ) {
+        this->fail("every address failed, last error: " + this->m_error);
+    }
+    return this->m_state;
+}
+
+bool TcpConnector::startAttempt(size_t addressIndex) {
+    const auto &address = this->m_addresses[addressIndex];
+    auto socketDescriptor = socket(address.family, address.socketType, address.protocol);
+    if (socketDescriptor == INVALID_SOCKET) {
+        auto errorCode = getLastError();
+        this->m_error = describeAddress(address) + ": socket(int, int, int): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')';
+        return false;
+    }
+    try {
+        this->m_socketOptions.apply(socketDescriptor);
+    } catch (std::exception &e) {
+        this->m_error = describeAddress(address) + ": " + e.what();
+        closeSocket(socketDescriptor);
+        return false;
+    }
+    if (!setBlocking(socketDescriptor, false)) {
+        auto errorCode = getLastError();
+        this->m_error = describeAddress(address) + ": setting non-blocking mode: error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')';
+        closeSocket(socketDescriptor);
+        return false;
+    }
+    this->m_attempts.push_back(Attempt{socketDescriptor, addressIndex});
+    if (::connect(socketDescriptor, reinterpret_cast<const sockaddr *>(&address.address), address.addressLength) == 0) {
+        //Loopback connections can complete immediately
+        this->finish(this->m_attempts.size() - 1);
+        return true;
+    }
+    auto errorCode = getLastError();
+    if (!isInProgress(errorCode)) {
+        this->m_error = describeAddress(address) + ": connect(int, const sockaddr *, socklen_t): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')';
+        closeSocket(socketDescriptor);
+        this->m_attempts.pop_back();
+        return false;
+    }
+    return true;
+}
+
+void TcpConnector::finish(size_t attemptIndex) {
+    auto winner = this->m_attempts[attemptIndex];
+    this->m_attempts.erase(this->m_attempts.begin() + static_cast<std::ptrdiff_t>(attemptIndex));
+    this->closeAttempts();
+    if (!setBlocking(winner.socketDescriptor, true)) {
+        auto errorCode = getLastError();
+        closeSocket(winner.socketDescriptor);
+        this->fail(describeAddress(this->m_addresses[winner.addressIndex]) + ": restoring blocking mode: error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+        return;
+    }
+    this->m_connectedDescriptor = winner.socketDescriptor;
+    this->m_connectedAddress = winner.addressIndex;
+    this->m_error = "";
+    this->m_state = State::Connected;
+}
+
+void TcpConnector::fail(const std::string &error) {
+    this->closeAttempts();
+    this->m_error = error;
+    this->m_state = State::Failed;
+}
+
+void TcpConnector::closeAttempts() {
+    for (const auto &attempt : this->m_attempts) {
+        closeSocket(attempt.socketDescriptor);
+    }
+    this->m_attempts.clear();
+}
+
+TcpConnector::State TcpConnector::run() {
+    while (this->advance() == State::Connecting) {
+        auto descriptors = this->pendingDescriptors();
+        DescriptorWaiter::waitForAny(descriptors.data(), descriptors.size(), POLLOUT, this->nextWakeup());
+    }
+    return this->m_state;
+}
+
+TcpConnector::State TcpConnector::state() const {
+    return this->m_state;
+}
+
+std::string TcpConnector::error() const {
+    return this->m_error;
+}
+
+std::vector<socket_t> TcpConnector::pendingDescriptors() const {
+    std::vector<socket_t> descriptors{};
+    descriptors.reserve(this->m_attempts.size());
+    for (const auto &attempt : this->m_attempts) {
+        descriptors.push_back(attempt.socketDescriptor);
+    }
+    return descriptors;
+}
+
+std::chrono::steady_clock::time_point TcpConnector::nextWakeup() const {
+    if (this->m_nextAddress < this->m_addresses.size()) {
+        return std::min(this->m_nextAttemptAt, this->m_deadline);
+    }
+    return this->m_deadline;
+}
+
+socket_t TcpConnector::takeDescriptor() {
+    if (this->m_state != State::Connected) {
+        throw std::runtime_error("CppSerialPort::TcpConnector::takeDescriptor(): Not connected (" + this->m_error + ')');
+    }
+    if (this->m_connectedDescriptor == INVALID_SOCKET) {
+        throw std::runtime_error("CppSerialPort::TcpConnector::takeDescriptor(): The connected descriptor was already taken");
+    }
+    auto socketDescriptor = this->m_connectedDescriptor;
+    this->m_connectedDescriptor = INVALID_SOCKET;
+    return socketDescriptor;
+}
+
+std::unique_ptr<TcpSocket> TcpConnector::takeSocket() {
+    const auto &address = this->connectedAddress();
+    auto socketDescriptor = this->takeDescriptor();
+    try {
+        return std::unique_ptr<TcpSocket>{new TcpSocket{socketDescriptor, reinterpret_cast<const sockaddr *>(&address.address), address.addressLength}};
+    } catch (std::exception &e) {
+        (void)e;
+        closeSocket(socketDescriptor);
+        throw;
+    }
+}
+
+const ResolvedAddress &TcpConnector::connectedAddress() const {
+    if (this->m_state != State::Connected) {
+        throw std::runtime_error("CppSerialPort::TcpConnector::connectedAddress(): Not connected (" + this->m_error + ')');
+    }
+    return this->m_addresses[this->m_connectedAddress];
+}
+
+} //namespace CppSerialPort
@@ -0,0 +1,272 @@
+#include <CppSerialPort/TcpServer.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+#include <CppSerialPort/DescriptorWaiter.hpp>
+
+#if defined(_WIN32)
+#    include <ws2tcpip.h>
+#    include <winsock2.h>
+     using sockopt_t = char;
+#else
+#    include <unistd.h>
+#    include <fcntl.h>
+#    define INVALID_SOCKET (-1)
+     using sockopt_t = int;
+#endif //defined(_WIN32)
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using NetworkErrorInformation::getLastError;
+using NetworkErrorInformation::getErrorString;
+
+namespace {
+    void closeSocket(socket_t socketDescriptor) {
+#if defined(_WIN32)
+        closesocket(socketDescriptor);
+#else
+        close(socketDescriptor);
+#endif //defined(_WIN32)
+    }
+
+    bool isWouldBlock(int errorCode) {
+#if defined(_WIN32)
+        return (errorCode == WSAEWOULDBLOCK);
+#else
+        return ( (errorCode == EAGAIN) || (errorCode == EWOULDBLOCK) );
+#endif //defined(_WIN32)
+    }
+
+#if !defined(__linux__)
+    void setBlocking(socket_t socketDescriptor, bool blocking) {
+#if defined(_WIN32)
+        unsigned long mode{blocking ? 0UL : 1UL};
+        ioctlsocket(socketDescriptor, FIONBIO, &mode);
+#else
+        auto flags = fcntl(socketDescriptor, F_GETFL, 0);
+        fcntl(socketDescriptor, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+#endif //defined(_WIN32)
+    }
+#endif //!defined(__linux__)
+}
+
+namespace CppSerialPort {
+
+const int TcpServer::DEFAULT_BACKLOG{SOMAXCONN};
+
+TcpServer::TcpServer(uint16_t portNumber, const std::string &bindAddress) :
+    m_socketDescriptor{INVALID_SOCKET},
+    m_portNumber{portNumber},
+    m_bindAddress{bindAddress},
+    m_backlog{DEFAULT_BACKLOG},
+    m_reusePort{false}
+{
+#if defined(_WIN32)
+    WSADATA wsaData{};
+    memset(&wsaData, 0, sizeof(WSADATA));
+    auto wsaStartupResult = WSAStartup(MAKEWORD(2, 0), &wsaData);
+    if (wsaStartupResult != 0) {
+        throw std::runtime_error("CppSerialPort::TcpServer::TcpServer(uint16_t, const std::string &): WSAStartup failed: error code " + std::to_string(wsaStartupResult) + " (" + getErrorString(wsaStartupResult) + ')');
+    }
+#endif //defined(_WIN32)
+}
+
+TcpServer::~TcpServer() {
+    this->close();
+}
+
+void TcpServer::listen() {
+    if (this->isListening()) {
+        throw std::runtime_error("CppSerialPort::TcpServer::listen(): Already listening (call close() first)");
+    }
+    addrinfo hints{};
+    memset(reinterpret_cast<void *>(&hints), 0, sizeof(addrinfo));
+    hints.ai_family = AF_UNSPEC; //IPV4 or IPV6
+    hints.ai_socktype = SOCK_STREAM; //TCP
+    hints.ai_flags = AI_PASSIVE; //Any local address when no bind address is given
+    addrinfo *addressInfo{nullptr};
+    auto returnStatus = getaddrinfo(this->m_bindAddress.empty() ? nullptr : this->m_bindAddress.c_str(), std::to_string(this->m_portNumber).c_str(), &hints, &addressInfo);
+    if (returnStatus != 0) {
+        throw std::runtime_error("CppSerialPort::TcpServer::listen(): getaddrinfo(const char *, const char *, const addrinfo *, addrinfo **): error code " + std::to_string(returnStatus) + " (" + gai_strerror(returnStatus) + ')');
+    }
+
+    int errorCode{0};
+    std::string failedCall{""};
+    for (auto candidate = addressInfo; candidate != nullptr; candidate = candidate->ai_next) {
+#if defined(__linux__)
+        auto socketDescriptor = socket(candidate->ai_family, candidate->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, candidate->ai_protocol);
+#else
+        auto socketDescriptor = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+#endif //defined(__linux__)
+        if (socketDescriptor == INVALID_SOCKET) {
+            errorCode = getLastError();
+            failedCall = "socket(int, int, int)";
+            continue;
+        }
+        sockopt_t enable{1};
+        setsockopt(socketDescriptor, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        if (this->m_reusePort) {
+#if defined(SO_REUSEPORT)
+            //Several servers (usually one per thread) bound to the same port each get their own accept queue
+            if (setsockopt(socketDescriptor, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) == -1) {
+                errorCode = getLastError();
+                failedCall = "setsockopt(int, int, int, const void *, socklen_t)";
+                closeSocket(socketDescriptor);
+                continue;
+            }
+#else
+            freeaddrinfo(addressInfo);
+            closeSocket(socketDescriptor);
+            throw std::runtime_error("CppSerialPort::TcpServer::listen(): SO_REUSEPORT is not supported on this platform");
+#endif //defined(SO_REUSEPORT)
+        }
+        if (bind(socketDescriptor, candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)) != 0) {
+            errorCode = getLastError();
+            failedCall = "bind(int, const sockaddr *, socklen_t)";
+            closeSocket(socketDescriptor);
+            continue;
+        }
+        if (::listen(socketDescriptor, this->m_backlog) != 0) {
+            errorCode = getLastError();
+            failedCall = "listen(int, int)";
+            closeSocket(socketDescriptor);
+            continue;
+        }
+#if !defined(__linux__)
+        setBlocking(socketDescriptor, false);
+#endif //!defined(__linux__)
+        this->m_socketDescriptor = socketDescriptor;
+        break;
+    }
+    freeaddrinfo(addressInfo);
+    if (!this->isListening()) {
+        throw std::runtime_error("CppSerialPort::TcpServer::listen(): " + failedCall + ": error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+
+    //Port 0 asks the kernel for any free port, so report the one it chose
+    sockaddr_storage boundAddress{};
+    socklen_t boundAddressLength{sizeof(boundAddress)};
+    if (getsockname(this->m_socketDescriptor, reinterpret_cast<sockaddr *>(&boundAddress), &boundAddressLength) == 0) {
+        if (boundAddress.ss_family == AF_INET) {
+            this->m_portNumber = ntohs(reinterpret_cast<sockaddr_in *>(&boundAddress)->sin_port);
+        } else if (boundAddress.ss_family == AF_INET6) {
+            this->m_portNumber = ntohs(reinterpret_cast<sockaddr_in6 *>(&boundAddress)->sin6_port);
+        }
+    }
+}
+
+void TcpServer::close() {
+    if (!this->isListening()) {
+        return;
+    }
+    closeSocket(this->m_socketDescriptor);
+    this->m_socketDescriptor = INVALID_SOCKET;
+}
+
+bool TcpServer::isListening() const {
+    return (this->m_socketDescriptor != INVALID_SOCKET);
+}
+
+std::unique_ptr<TcpSocket> TcpServer::accept(std::chrono::steady_clock::time_point deadline) {
+    while (true) {
+        auto acceptedSocket = this->tryAccept();
+        if (acceptedSocket) {
+            return acceptedSocket;
+        }
+        if (!DescriptorWaiter::waitForReadable(this->m_socketDescriptor, deadline)) {
+            return nullptr;
+        }
+    }
+}
+
+std::unique_ptr<TcpSocket> TcpServer::tryAccept() {
+    if (!this->isListening()) {
+        throw std::runtime_error("CppSerialPort::TcpServer::tryAccept(): Cannot accept on a closed server (call listen() first)");
+    }
+    while (true) {
+        sockaddr_storage peerAddress{};
+        socklen_t peerAddressLength{sizeof(peerAddress)};
+#if defined(__linux__)
+        //Accepted sockets are left blocking, since TcpSocket waits with poll() and relies on its send and receive timeouts
+        auto acceptedDescriptor = accept4(this->m_socketDescriptor, reinterpret_cast<sockaddr *>(&peerAddress), &peerAddressLength, SOCK_CLOEXEC);
+#else
+        auto acceptedDescriptor = ::accept(this->m_socketDescriptor, reinterpret_cast<sockaddr *>(&peerAddress), &peerAddressLength);
+#endif //defined(__linux__)
+        if (acceptedDescriptor == INVALID_SOCKET) {
+            auto errorCode = getLastError();
+            if ( (errorCode == EINTR) || (errorCode == ECONNABORTED) ) {
+                continue;
+            }
+            if (isWouldBlock(errorCode)) {
+                return nullptr;
+            }
+            throw std::runtime_error("CppSerialPort::TcpServer::tryAccept(): accept(int, sockaddr *, socklen_t *): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+#if !defined(__linux__)
+        //Elsewhere the accepted socket inherits the listening socket's non-blocking flag
+        setBlocking(acceptedDescriptor, true);
+#endif //!defined(__linux__)
+        try {
+            return std::unique_ptr<TcpSocket>{new TcpSocket{acceptedDescriptor, reinterpret_cast<sockaddr *>(&peerAddress), peerAddressLength}};
+        } catch (std::exception &e) {
+            (void)e;
+            closeSocket(acceptedDescriptor);
+            throw;
+        }
+    }
+}
+
+std::vector<std::unique_ptr<TcpSocket>> TcpServer::acceptPending() {
+    std::vector<std::unique_ptr<TcpSocket>> acceptedSockets{};
+    while (true) {
+        auto acceptedSocket = this->tryAccept();
+        if (!acceptedSocket) {
+            break;
+        }
+        acceptedSockets.push_back(std::move(acceptedSocket));
+    }
+    return acceptedSockets;
+}
+
+void TcpServer::setBacklog(int backlog) {
+    if (backlog <= 0) {
+        throw std::runtime_error("CppSerialPort::TcpServer::setBacklog(int): backlog must be greater than 0 (" + std::to_string(backlog) + " <= 0)");
+    }
+    this->m_backlog = backlog;
+    if (this->isListening()) {
+        ::listen(this->m_socketDescriptor, this->m_backlog);
+    }
+}
+
+int TcpServer::backlog() const {
+    return this->m_backlog;
+}
+
+void TcpServer::setReusePort(bool reusePort) {
+    if (this->isListening()) {
+        throw std::runtime_error("CppSerialPort::TcpServer::setReusePort(bool): Cannot change SO_REUSEPORT while listening (call close() first)");
+    }
+    this->m_reusePort = reusePort;
+}
+
+bool TcpServer::reusePort() const {
+    return this->m_reusePort;
+}
+
+uint16_t TcpServer::portNumber() const {
+    return this->m_portNumber;
+}
+
+std::string TcpServer::bindAddress() const {
+    return this->m_bindAddress;
+}
+
+int TcpServer::fileDescriptor() const {
+#if defined(_WIN32)
+    return -1;
+#else
+    return this->m_socketDescriptor;
+#endif //defined(_WIN32)
+}
+
+} //namespace CppSerialPort
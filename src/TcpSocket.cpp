@@ -1,5 +1,7 @@
 #include <CppSerialPort/TcpSocket.hpp>
 #include <CppSerialPort/ErrorInformation.hpp>
+#include <CppSerialPort/DescriptorWaiter.hpp>
+#include <CppSerialPort/TcpConnector.hpp>
 
 #if defined(_WIN32)
 #    include <ws2tcpip.h>
@@ -7,39 +9,123 @@
 #else
 #    include <unistd.h>
 #    include <fcntl.h>
+#    include <sys/uio.h>
+#    include <netinet/tcp.h>
+#    define INVALID_SOCKET (-1)
      using getsockopt_t = int;
 #endif //defined(_WIN32)
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
 #include <climits>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
 
 using NetworkErrorInformation::getLastError;
 using NetworkErrorInformation::getErrorString;
 
+namespace {
+    void closeSocket(socket_t socketDescriptor) {
+#if defined(_WIN32)
+        closesocket(socketDescriptor);
+#else
+        close(socketDescriptor);
+#endif //defined(_WIN32)
+    }
+}
+
 namespace CppSerialPort {
 
 #define TCP_CLIENT_BUFFER_MAX 8192
 
+//State shared between the socket and the thread reestablishing its connection
+//The thread only ever connects a new descriptor and publishes it; the socket adopts it on its own thread
+struct TcpSocket::Reconnector {
+    explicit Reconnector(const ReconnectPolicy &reconnectPolicy) :
+        policy{reconnectPolicy},
+        thread{},
+        mutex{},
+        condition{},
+        stopping{false},
+        reconnecting{false},
+        failed{false},
+        readyDescriptor{INVALID_SOCKET},
+        readyAddress{},
+        attempts{0},
+        reconnects{0},
+        lastReconnectLatency{0},
+        disconnectedAt{},
+        lastError{""},
+        hostName{""},
+        portNumber{0},
+        hints{},
+        socketOptions{},
+        connectTimeout{0},
+        streamMutex{},
+        replayBuffer{},
+        rejectedBytes{0}
+    {
+
+    }
+
+    const ReconnectPolicy policy;
+    std::thread thread;
+
+    //Guards everything down to streamMutex
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+    bool reconnecting;
+    bool failed;
+    socket_t readyDescriptor;
+    ResolvedAddress readyAddress;
+    uint64_t attempts;
+    uint64_t reconnects;
+    std::chrono::microseconds lastReconnectLatency;
+    std::chrono::steady_clock::time_point disconnectedAt;
+    std::string lastError;
+    //Copied when a reconnect starts, so the thread never touches the socket itself
+    std::string hostName;
+    uint16_t portNumber;
+    addrinfo hints;
+    SocketOptions socketOptions;
+    std::chrono::microseconds connectTimeout;
+
+    //Held while adopting a new connection and while writing, so replayed bytes always go out before newer writes
+    std::recursive_mutex streamMutex;
+    ByteRingBuffer replayBuffer;
+    uint64_t rejectedBytes;
+};
+
 TcpSocket::TcpSocket(const IPV4Address &ipAddress, uint16_t portNumber) :
-        AbstractSocket(ipAddress, portNumber)
+        AbstractSocket(ipAddress, portNumber),
+        m_reconnector{nullptr}
 {
 
 }
 
 TcpSocket::TcpSocket(const std::string &hostName, uint16_t portNumber) :
-        AbstractSocket(hostName, portNumber)
+        AbstractSocket(hostName, portNumber),
+        m_reconnector{nullptr}
 {
 
 }
 
-void TcpSocket::doConnect() {
-    fd_set fileDescriptorSet{};
-    struct timeval timeout{3, 0}; //3 seconds, 0 milliseconds
+TcpSocket::TcpSocket(socket_t connectedDescriptor, const sockaddr *peerAddress, socklen_t peerAddressLength) :
+        AbstractSocket(connectedDescriptor, peerAddress, peerAddressLength),
+        m_reconnector{nullptr}
+{
 
-    FD_ZERO(&fileDescriptorSet);
-    FD_SET(this->socketDescriptor(), &fileDescriptorSet);
+}
+
+TcpSocket::~TcpSocket() {
+    this->disableReconnect();
+}
 
+void TcpSocket::doConnect() {
     this->setBlockingFlag(false); //Set socket to non-blocking mode
 
     auto connectResult = ::connect(this->socketDescriptor(), this->addressInfo()->ai_addr, static_cast<int>(this->addressInfo()->ai_addrlen));
@@ -51,25 +137,31 @@ void TcpSocket::doConnect() {
     */
     (void)connectResult;
 
-    //Windows will return 1 if the connection was successful, 0 otherwise, and will always return 0 for socketError, because logic
-    if (select(static_cast<int>(this->socketDescriptor() + 1), nullptr, &fileDescriptorSet, nullptr, &timeout) == 1) {
-#if !defined(_WIN32)
-        getsockopt_t socketError{};
+    //The socket becomes writable once the connection completes or fails, and SO_ERROR says which
+    if (DescriptorWaiter::waitForWritable(this->socketDescriptor(), deadlineAfter(this->connectTimeout()))) {
+        int socketError{0};
         socklen_t socketErrorLength{sizeof(socketError)};
 
-        getsockopt(this->socketDescriptor(), SOL_SOCKET, SO_ERROR, &socketError, &socketErrorLength);
+        getsockopt(this->socketDescriptor(), SOL_SOCKET, SO_ERROR, reinterpret_cast<getsockopt_t *>(&socketError), &socketErrorLength);
 
         if (socketError != 0) {
-            auto errorCode = getLastError();
-            throw std::runtime_error("CppSerialPort::TcpSocket::doConnect(): doConnect(addrinfo *): connect(int, sockaddr *, size_t) failed with error code " + toStdString(errorCode) +  " (" + getErrorString(errorCode) + ')');
+            throw std::runtime_error("CppSerialPort::TcpSocket::doConnect(): doConnect(addrinfo *): connect(int, sockaddr *, size_t) failed with error code " + toStdString(socketError) +  " (" + getErrorString(socketError) + ')');
         }
-#endif //!defined(_WIN32)
     } else {
         throw std::runtime_error("CppSerialPort::TcpSocket::doConnect(): doConnect(addrinfo *): connect(int, sockaddr *, size_t) did not complete in the specified time frame");
     }
     this->setBlockingFlag(true); //Return socket to blocking mode
 }
 
+void TcpSocket::connectToAny(const std::vector<ResolvedAddress> &addresses, std::chrono::steady_clock::time_point deadline) {
+    TcpConnector connector{addresses, deadline, this->socketOptions()};
+    if (connector.run() != TcpConnector::State::Connected) {
+        throw std::runtime_error("CppSerialPort::TcpSocket::connectToAny(const std::vector<ResolvedAddress> &, std::chrono::steady_clock::time_point): Could not connect to " + this->hostName() + ':' + toStdString(this->portNumber()) + ": " + connector.error());
+    }
+    auto address = connector.connectedAddress();
+    this->adoptConnection(connector.takeDescriptor(), address);
+}
+
 addrinfo TcpSocket::getAddressInfoHints() {
     addrinfo hints{0, 0, 0, 0, 0, nullptr, nullptr, nullptr};
     memset(reinterpret_cast<void *>(&hints), 0, sizeof(addrinfo));
@@ -84,9 +176,337 @@ ssize_t TcpSocket::doWrite(const char *bytes, size_t byteCount) {
     return send(this->socketDescriptor(), bytes, byteCount, 0);
 }
 
+ssize_t TcpSocket::doWrite(const ConstBuffer *buffers, size_t count) {
+#if defined(_WIN32)
+    std::vector<WSABUF> wsaBuffers(count);
+    for (size_t i = 0; i < count; i++) {
+        wsaBuffers[i].buf = const_cast<char *>(buffers[i].data);
+        wsaBuffers[i].len = static_cast<ULONG>(buffers[i].length);
+    }
+    DWORD sentBytes{0};
+    if (WSASend(this->socketDescriptor(), wsaBuffers.data(), static_cast<DWORD>(wsaBuffers.size()), &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR) {
+        return -1;
+    }
+    return static_cast<ssize_t>(sentBytes);
+#else
+    std::vector<iovec> ioVectors(std::min<size_t>(count, IOV_MAX));
+    for (size_t i = 0; i < ioVectors.size(); i++) {
+        ioVectors[i].iov_base = const_cast<char *>(buffers[i].data);
+        ioVectors[i].iov_len = buffers[i].length;
+    }
+    msghdr message{};
+    message.msg_iov = ioVectors.data();
+    message.msg_iovlen = ioVectors.size();
+    return sendmsg(this->socketDescriptor(), &message, 0);
+#endif //defined(_WIN32)
+}
+
 ssize_t TcpSocket::doRead(char *buffer, size_t bufferMax) {
-    return recv(this->socketDescriptor(), buffer, bufferMax, 0);
+#if defined(_WIN32)
+    auto receiveResult = recv(this->socketDescriptor(), buffer, bufferMax, 0);
+#else
+    auto receiveResult = this->isChunkTimestamping() ? this->receiveTimestamped(buffer, bufferMax) : recv(this->socketDescriptor(), buffer, bufferMax, 0);
+#endif //defined(_WIN32)
+#if defined(TCP_QUICKACK)
+    //The kernel drops back to delayed ACKs on its own, so quick ACK mode has to be requested again after each receive
+    if ( (receiveResult > 0) && (this->socketOptions().quickAck()) ) {
+        int quickAck{1};
+        setsockopt(this->socketDescriptor(), IPPROTO_TCP, TCP_QUICKACK, &quickAck, sizeof(quickAck));
+    }
+#endif //defined(TCP_QUICKACK)
+    return receiveResult;
+}
+
+void TcpSocket::setNoDelay(bool noDelay) {
+    this->setSocketOptions(SocketOptions{}.setNoDelay(noDelay));
+}
+
+bool TcpSocket::noDelay() const {
+    return (this->socketOption(IPPROTO_TCP, TCP_NODELAY) != 0);
+}
+
+void TcpSocket::setQuickAck(bool quickAck) {
+    this->setSocketOptions(SocketOptions{}.setQuickAck(quickAck));
+}
+
+void TcpSocket::enableReconnect(const ReconnectPolicy &policy) {
+    if ( (policy.initialDelay.count() <= 0) || (policy.maximumDelay < policy.initialDelay) ) {
+        throw std::runtime_error("CppSerialPort::TcpSocket::enableReconnect(const ReconnectPolicy &): initialDelay must be greater than 0 and no greater than maximumDelay");
+    }
+    if ( (policy.multiplier < 1.0) || (policy.jitter < 0.0) || (policy.jitter > 1.0) ) {
+        throw std::runtime_error("CppSerialPort::TcpSocket::enableReconnect(const ReconnectPolicy &): multiplier must be at least 1 and jitter must be between 0 and 1");
+    }
+    this->disableReconnect();
+    this->m_reconnector.reset(new Reconnector{policy});
+}
+
+void TcpSocket::disableReconnect() {
+    if (!this->m_reconnector) {
+        return;
+    }
+    this->stopReconnect();
+    this->m_reconnector.reset();
+}
+
+bool TcpSocket::isReconnectEnabled() const {
+    return (this->m_reconnector != nullptr);
+}
+
+ReconnectStatistics TcpSocket::reconnectStatistics() const {
+    ReconnectStatistics statistics{false, 0, 0, std::chrono::microseconds{0}, 0, 0, ""};
+    if (!this->m_reconnector) {
+        return statistics;
+    }
+    auto &reconnector = *this->m_reconnector;
+    {
+        std::lock_guard<std::recursive_mutex> streamLock{reconnector.streamMutex};
+        statistics.replayBufferSize = reconnector.replayBuffer.size();
+        statistics.rejectedBytes = reconnector.rejectedBytes;
+    }
+    std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+    statistics.reconnecting = reconnector.reconnecting;
+    statistics.attempts = reconnector.attempts;
+    statistics.reconnects = reconnector.reconnects;
+    statistics.lastReconnectLatency = reconnector.lastReconnectLatency;
+    statistics.lastError = reconnector.lastError;
+    return statistics;
+}
+
+void TcpSocket::startReconnect() {
+    auto &reconnector = *this->m_reconnector;
+    std::lock_guard<std::recursive_mutex> streamLock{reconnector.streamMutex};
+    {
+        std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+        if ( (reconnector.reconnecting) || (reconnector.readyDescriptor != INVALID_SOCKET) ) {
+            return;
+        }
+    }
+    //A previous thread has always finished by now, since its connection was adopted before this one could drop
+    if (reconnector.thread.joinable()) {
+        reconnector.thread.join();
+    }
+    {
+        std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+        reconnector.stopping = false;
+        reconnector.reconnecting = true;
+        reconnector.failed = false;
+        reconnector.disconnectedAt = std::chrono::steady_clock::now();
+        reconnector.hostName = this->hostName();
+        reconnector.portNumber = this->portNumber();
+        reconnector.hints = this->getAddressInfoHints();
+        reconnector.socketOptions = this->socketOptions();
+        reconnector.connectTimeout = this->connectTimeout();
+    }
+    reconnector.thread = std::thread{&TcpSocket::runReconnect, this};
+}
+
+void TcpSocket::runReconnect() {
+    auto &reconnector = *this->m_reconnector;
+    std::mt19937 generator{std::random_device{}()};
+    std::uniform_real_distribution<double> jitter{1.0 - reconnector.policy.jitter, 1.0};
+    auto delay = std::chrono::duration<double, std::micro>{reconnector.policy.initialDelay};
+    size_t attempts{0};
+    while (true) {
+        {
+            std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+            if (reconnector.stopping) {
+                reconnector.reconnecting = false;
+                reconnector.condition.notify_all();
+                return;
+            }
+            reconnector.attempts++;
+        }
+        attempts++;
+        std::string error{""};
+        try {
+            auto addresses = HostResolver::instance().resolve(reconnector.hostName, reconnector.portNumber, reconnector.hints);
+            TcpConnector connector{*addresses, deadlineAfter(reconnector.connectTimeout), reconnector.socketOptions};
+            if (connector.run() == TcpConnector::State::Connected) {
+                std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+                reconnector.readyAddress = connector.connectedAddress();
+                reconnector.readyDescriptor = connector.takeDescriptor();
+                reconnector.reconnects++;
+                reconnector.lastReconnectLatency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - reconnector.disconnectedAt);
+                reconnector.reconnecting = false;
+                reconnector.condition.notify_all();
+                return;
+            }
+            error = connector.error();
+        } catch (std::exception &e) {
+            error = e.what();
+        }
+
+        std::unique_lock<std::mutex> reconnectLock{reconnector.mutex};
+        reconnector.lastError = error;
+        if ( (reconnector.policy.maximumAttempts != 0) && (attempts >= reconnector.policy.maximumAttempts) ) {
+            reconnector.failed = true;
+            reconnector.reconnecting = false;
+            reconnector.condition.notify_all();
+            return;
+        }
+        auto backoff = std::chrono::duration_cast<std::chrono::microseconds>(delay * jitter(generator));
+        reconnector.condition.wait_for(reconnectLock, backoff, [&reconnector]() { return reconnector.stopping; });
+        delay = std::min(delay * reconnector.policy.multiplier, std::chrono::duration<double, std::micro>{reconnector.policy.maximumDelay});
+    }
+}
+
+bool TcpSocket::adoptReconnected() {
+    auto &reconnector = *this->m_reconnector;
+    std::lock_guard<std::recursive_mutex> streamLock{reconnector.streamMutex};
+    if (!this->isConnected()) {
+        socket_t readyDescriptor{INVALID_SOCKET};
+        ResolvedAddress readyAddress{};
+        {
+            std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+            if (reconnector.failed) {
+                throw SocketDisconnectedException{this->portName(), "CppSerialPort::TcpSocket::adoptReconnected(): Gave up reconnecting after " + toStdString(reconnector.policy.maximumAttempts) + " attempts, last error: " + reconnector.lastError};
+            }
+            std::swap(readyDescriptor, reconnector.readyDescriptor);
+            readyAddress = reconnector.readyAddress;
+        }
+        if (readyDescriptor == INVALID_SOCKET) {
+            return false;
+        }
+        if (reconnector.thread.joinable()) {
+            reconnector.thread.join();
+        }
+        this->adoptConnection(readyDescriptor, readyAddress);
+        this->setReadTimeout(this->readTimeoutDuration());
+        this->setWriteTimeout(this->writeTimeoutDuration());
+    }
+
+    //Whatever was written during the outage goes out first
+    while (!reconnector.replayBuffer.empty()) {
+        auto pending = reconnector.replayBuffer.frontSpan();
+        const ConstBuffer buffer{pending.first, pending.second};
+        ssize_t sentBytes{0};
+        try {
+            sentBytes = AbstractSocket::writeBuffers(&buffer, 1);
+        } catch (SocketDisconnectedException &e) {
+            (void)e;
+            this->startReconnect();
+            return false;
+        }
+        reconnector.replayBuffer.consume(static_cast<size_t>(sentBytes));
+        if (static_cast<size_t>(sentBytes) < pending.second) {
+            //Hit the write timeout, so the rest waits for the next write
+            break;
+        }
+    }
+    return this->isConnected();
+}
+
+bool TcpSocket::waitForReconnect(std::chrono::steady_clock::time_point deadline) {
+    auto &reconnector = *this->m_reconnector;
+    std::unique_lock<std::mutex> reconnectLock{reconnector.mutex};
+    reconnector.condition.wait_until(reconnectLock, deadline, [&reconnector]() {
+        return ( (reconnector.readyDescriptor != INVALID_SOCKET) || (!reconnector.reconnecting) );
+    });
+    return ( (reconnector.readyDescriptor != INVALID_SOCKET) || (reconnector.failed) );
 }
 
+void TcpSocket::stopReconnect() {
+    auto &reconnector = *this->m_reconnector;
+    {
+        std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+        reconnector.stopping = true;
+    }
+    reconnector.condition.notify_all();
+    if (reconnector.thread.joinable()) {
+        reconnector.thread.join();
+    }
+    std::lock_guard<std::mutex> reconnectLock{reconnector.mutex};
+    if (reconnector.readyDescriptor != INVALID_SOCKET) {
+        closeSocket(reconnector.readyDescriptor);
+        reconnector.readyDescriptor = INVALID_SOCKET;
+    }
+    reconnector.stopping = false;
+    reconnector.reconnecting = false;
+    reconnector.failed = false;
+}
+
+size_t TcpSocket::readFromDevice(char *buffer, size_t maximum, std::chrono::steady_clock::time_point deadline) {
+    if (!this->m_reconnector) {
+        return AbstractSocket::readFromDevice(buffer, maximum, deadline);
+    }
+    while (true) {
+        if (this->adoptReconnected()) {
+            try {
+                return AbstractSocket::readFromDevice(buffer, maximum, deadline);
+            } catch (SocketDisconnectedException &e) {
+                (void)e;
+                this->startReconnect();
+            }
+        }
+        if (!this->waitForReconnect(deadline)) {
+            return 0;
+        }
+    }
+}
+
+ssize_t TcpSocket::writeBuffers(const ConstBuffer *buffers, size_t count) {
+    if (!this->m_reconnector) {
+        return AbstractSocket::writeBuffers(buffers, count);
+    }
+    auto &reconnector = *this->m_reconnector;
+    std::lock_guard<std::recursive_mutex> streamLock{reconnector.streamMutex};
+    if ( (this->adoptReconnected()) && (reconnector.replayBuffer.empty()) ) {
+        try {
+            return AbstractSocket::writeBuffers(buffers, count);
+        } catch (SocketDisconnectedException &e) {
+            (void)e;
+            this->startReconnect();
+        }
+    }
+    size_t byteCount{0};
+    for (size_t i = 0; i < count; i++) {
+        byteCount += buffers[i].length;
+    }
+    if (reconnector.replayBuffer.size() + byteCount > reconnector.policy.replayBufferCapacity) {
+        reconnector.rejectedBytes += byteCount;
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        reconnector.replayBuffer.append(buffers[i].data, buffers[i].length);
+    }
+    return static_cast<ssize_t>(byteCount);
+}
+
+ssize_t TcpSocket::write(char c) {
+    if (!this->m_reconnector) {
+        return AbstractSocket::write(c);
+    }
+    return this->write(&c, 1);
+}
+
+ssize_t TcpSocket::write(const char *bytes, size_t byteCount) {
+    if (!this->m_reconnector) {
+        return AbstractSocket::write(bytes, byteCount);
+    }
+    const ConstBuffer buffer{bytes, byteCount};
+    return this->writeBuffers(&buffer, 1);
+}
+
+ByteArray TcpSocket::readAvailable() {
+    if (this->m_reconnector) {
+        this->adoptReconnected();
+    }
+    return AbstractSocket::readAvailable();
+}
+
+size_t TcpSocket::available() {
+    if ( (this->m_reconnector) && (!this->adoptReconnected()) ) {
+        return this->readBuffer().size();
+    }
+    return AbstractSocket::available();
+}
+
+void TcpSocket::closePort() {
+    //Also runs when a dropped connection is detected, before the reconnect starts, so the policy and replay buffer are kept
+    if (this->m_reconnector) {
+        this->stopReconnect();
+    }
+    AbstractSocket::closePort();
+}
 
 } //namespace CppSerialPort
@@ -0,0 +1,50 @@
+#include <CppSerialPort/Termios2.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using ErrorInformation::getLastError;
+using ErrorInformation::getErrorString;
+
+namespace CppSerialPort {
+
+namespace Termios2 {
+
+void setAttributes(int fileDescriptor, const Attributes &attributes, uint32_t baudRate) {
+    termios2 settings{};
+    memset(&settings, 0, sizeof(settings));
+    settings.c_iflag = attributes.inputFlags;
+    settings.c_oflag = attributes.outputFlags;
+    settings.c_lflag = attributes.localFlags;
+    settings.c_line = attributes.lineDiscipline;
+    memcpy(settings.c_cc, attributes.controlCharacters, std::min(sizeof(settings.c_cc), sizeof(attributes.controlCharacters)));
+    //Clearing CIBAUD makes the input rate follow the output rate
+    settings.c_cflag = attributes.controlFlags;
+    settings.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    settings.c_cflag |= BOTHER;
+    settings.c_ispeed = baudRate;
+    settings.c_ospeed = baudRate;
+    if (ioctl(fileDescriptor, TCSETS2, &settings) == -1) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::Termios2::setAttributes(int, const Attributes &, uint32_t): ioctl(int, TCSETS2, termios2 *): Unable to set " + std::to_string(baudRate) + " baud: error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+}
+
+uint32_t outputBaudRate(int fileDescriptor) {
+    termios2 settings{};
+    if (ioctl(fileDescriptor, TCGETS2, &settings) == -1) {
+        const auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::Termios2::outputBaudRate(int): ioctl(int, TCGETS2, termios2 *): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    return static_cast<uint32_t>(settings.c_ospeed);
+}
+
+} //namespace Termios2
+
+} //namespace CppSerialPort
@@ -3,19 +3,103 @@
 
 #if defined(_WIN32)
 #    include <ws2tcpip.h>
+#    include <iphlpapi.h>
 #else
 #    include <unistd.h>
+#    include <net/if.h>
+#    include <sys/uio.h>
 #endif //defined(_WIN32)
 
+#include <algorithm>
 #include <cstring>
+#include <stdexcept>
 #include <climits>
 #include <iostream>
 
 using NetworkErrorInformation::getLastError;
 using NetworkErrorInformation::getErrorString;
 
+namespace {
+#if defined(_WIN32)
+    using multicast_option_t = DWORD;
+#elif defined(__linux__)
+    using multicast_option_t = int;
+#else
+    //The BSDs only accept a single byte for the IPv4 TTL and loopback options
+    using multicast_option_t = u_char;
+#endif //defined(_WIN32)
+}
+
 namespace CppSerialPort {
 
+const size_t DatagramBatch::DEFAULT_CAPACITY{64};
+const size_t DatagramBatch::DEFAULT_MAXIMUM_DATAGRAM_SIZE{2048};
+
+DatagramBatch::DatagramBatch(size_t capacity, size_t maximumDatagramSize) :
+    m_maximumDatagramSize{maximumDatagramSize},
+    m_slab(capacity * maximumDatagramSize),
+    m_sources(capacity),
+    m_datagrams{}
+#if defined(__linux__)
+    ,m_ioVectors(capacity),
+    m_messageHeaders(capacity),
+    m_control(capacity * AbstractSocket::RECEIVE_TIMESTAMP_CONTROL_SIZE)
+#endif //defined(__linux__)
+{
+    if ( (capacity == 0) || (maximumDatagramSize == 0) ) {
+        throw std::runtime_error("CppSerialPort::DatagramBatch::DatagramBatch(size_t, size_t): capacity and maximumDatagramSize must both be greater than 0");
+    }
+    this->m_datagrams.reserve(capacity);
+#if defined(__linux__)
+    //The headers point into the slab once, here, so receiving never has to rebuild them
+    for (size_t i = 0; i < capacity; i++) {
+        this->m_ioVectors[i].iov_base = this->m_slab.data() + (i * maximumDatagramSize);
+        this->m_ioVectors[i].iov_len = maximumDatagramSize;
+        memset(&this->m_messageHeaders[i], 0, sizeof(mmsghdr));
+        this->m_messageHeaders[i].msg_hdr.msg_name = &this->m_sources[i];
+        this->m_messageHeaders[i].msg_hdr.msg_iov = &this->m_ioVectors[i];
+        this->m_messageHeaders[i].msg_hdr.msg_iovlen = 1;
+        this->m_messageHeaders[i].msg_hdr.msg_control = this->m_control.data() + (i * AbstractSocket::RECEIVE_TIMESTAMP_CONTROL_SIZE);
+    }
+#endif //defined(__linux__)
+}
+
+const Datagram &DatagramBatch::operator[](size_t index) const {
+    return this->m_datagrams[index];
+}
+
+const Datagram &DatagramBatch::at(size_t index) const {
+    return this->m_datagrams.at(index);
+}
+
+std::vector<Datagram>::const_iterator DatagramBatch::begin() const {
+    return this->m_datagrams.begin();
+}
+
+std::vector<Datagram>::const_iterator DatagramBatch::end() const {
+    return this->m_datagrams.end();
+}
+
+size_t DatagramBatch::size() const {
+    return this->m_datagrams.size();
+}
+
+bool DatagramBatch::empty() const {
+    return this->m_datagrams.empty();
+}
+
+size_t DatagramBatch::capacity() const {
+    return this->m_sources.size();
+}
+
+size_t DatagramBatch::maximumDatagramSize() const {
+    return this->m_maximumDatagramSize;
+}
+
+void DatagramBatch::clear() {
+    this->m_datagrams.clear();
+}
+
 UdpSocket::UdpSocket(const IPV4Address &ipAddress, uint16_t portNumber) :
     AbstractSocket{ipAddress, portNumber}
 {
@@ -28,6 +112,304 @@ UdpSocket::UdpSocket(const std::string &hostName, uint16_t portNumber) :
 
 }
 
+size_t UdpSocket::receiveBatch(DatagramBatch &batch) {
+    return this->receiveBatch(batch, deadlineAfter(this->readTimeoutDuration()));
+}
+
+size_t UdpSocket::receiveBatch(DatagramBatch &batch, std::chrono::steady_clock::time_point deadline) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::receiveBatch(DatagramBatch &, std::chrono::steady_clock::time_point): Cannot receive on closed socket (call connect first)");
+    }
+    batch.clear();
+    if (!this->waitForReadable(deadline)) {
+        return 0;
+    }
+#if defined(__linux__)
+    for (auto &it : batch.m_messageHeaders) {
+        it.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        it.msg_hdr.msg_controllen = this->isChunkTimestamping() ? RECEIVE_TIMESTAMP_CONTROL_SIZE : 0;
+        it.msg_hdr.msg_flags = 0;
+    }
+    auto receivedCount = recvmmsg(this->socketDescriptor(), batch.m_messageHeaders.data(), static_cast<unsigned int>(batch.m_messageHeaders.size()), MSG_DONTWAIT, nullptr);
+    if (receivedCount == -1) {
+        auto errorCode = getLastError();
+        if ( (errorCode == EAGAIN) || (errorCode == EWOULDBLOCK) || (errorCode == EINTR) ) {
+            return 0;
+        }
+        throw std::runtime_error("CppSerialPort::UdpSocket::receiveBatch(DatagramBatch &, std::chrono::steady_clock::time_point): recvmmsg(int, mmsghdr *, unsigned int, int, timespec *): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    for (int i = 0; i < receivedCount; i++) {
+        const auto &header = batch.m_messageHeaders[i];
+        batch.m_datagrams.push_back(Datagram{
+            static_cast<const char *>(header.msg_hdr.msg_iov->iov_base),
+            std::min<size_t>(header.msg_len, batch.m_maximumDatagramSize),
+            &batch.m_sources[i],
+            header.msg_hdr.msg_namelen,
+            (header.msg_hdr.msg_flags & MSG_TRUNC) != 0,
+            receiveTimestampFrom(header.msg_hdr)
+        });
+    }
+#else
+    //No recvmmsg here, so take whatever is already queued one datagram at a time
+    for (size_t i = 0; i < batch.capacity(); i++) {
+        if ( (i > 0) && (!this->waitForReadable(std::chrono::steady_clock::now())) ) {
+            break;
+        }
+        auto datagramStart = batch.m_slab.data() + (i * batch.m_maximumDatagramSize);
+        socklen_t sourceLength{sizeof(sockaddr_storage)};
+        auto receiveResult = recvfrom(this->socketDescriptor(), datagramStart, static_cast<int>(batch.m_maximumDatagramSize), 0, reinterpret_cast<sockaddr *>(&batch.m_sources[i]), &sourceLength);
+        if (receiveResult < 0) {
+            break;
+        }
+        batch.m_datagrams.push_back(Datagram{datagramStart, static_cast<size_t>(receiveResult), &batch.m_sources[i], sourceLength, false, ReceiveTimestamp{}});
+    }
+#endif //defined(__linux__)
+    return batch.size();
+}
+
+size_t UdpSocket::sendBatch(const std::vector<ConstBuffer> &datagrams) {
+    return this->sendBatch(datagrams.data(), datagrams.size());
+}
+
+size_t UdpSocket::sendBatch(const ConstBuffer *datagrams, size_t count) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::sendBatch(const ConstBuffer *, size_t): Cannot write on closed socket (call connect first)");
+    }
+    size_t sentCount{0};
+#if defined(__linux__)
+    //Reuse the header arrays between calls, so a steady stream of batches does not allocate
+    if (this->m_sendHeaders.size() < count) {
+        this->m_sendHeaders.resize(count);
+        this->m_sendVectors.resize(count);
+    }
+    for (size_t i = 0; i < count; i++) {
+        this->m_sendVectors[i].iov_base = const_cast<char *>(datagrams[i].data);
+        this->m_sendVectors[i].iov_len = datagrams[i].length;
+        memset(&this->m_sendHeaders[i], 0, sizeof(mmsghdr));
+        this->m_sendHeaders[i].msg_hdr.msg_name = this->addressInfo()->ai_addr;
+        this->m_sendHeaders[i].msg_hdr.msg_namelen = this->addressInfo()->ai_addrlen;
+        this->m_sendHeaders[i].msg_hdr.msg_iov = &this->m_sendVectors[i];
+        this->m_sendHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+    while (sentCount < count) {
+        auto sendResult = sendmmsg(this->socketDescriptor(), this->m_sendHeaders.data() + sentCount, static_cast<unsigned int>(count - sentCount), 0);
+        if (sendResult == -1) {
+            auto errorCode = getLastError();
+            if (errorCode == EINTR) {
+                continue;
+            }
+            if ( (sentCount > 0) || (errorCode == EAGAIN) || (errorCode == EWOULDBLOCK) ) {
+                break;
+            }
+            throw std::runtime_error("CppSerialPort::UdpSocket::sendBatch(const ConstBuffer *, size_t): sendmmsg(int, mmsghdr *, unsigned int, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+        sentCount += static_cast<size_t>(sendResult);
+    }
+#else
+    for (; sentCount < count; sentCount++) {
+        if (this->doWrite(datagrams[sentCount].data, datagrams[sentCount].length) < 0) {
+            break;
+        }
+    }
+#endif //defined(__linux__)
+    return sentCount;
+}
+
+void UdpSocket::joinGroup(const std::string &groupAddress, const std::string &interfaceName) {
+    this->changeMembership(groupAddress, interfaceName, true);
+}
+
+void UdpSocket::leaveGroup(const std::string &groupAddress, const std::string &interfaceName) {
+    this->changeMembership(groupAddress, interfaceName, false);
+}
+
+void UdpSocket::changeMembership(const std::string &groupAddress, const std::string &interfaceName, bool join) {
+    std::string methodName{join ? "joinGroup" : "leaveGroup"};
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::" + methodName + "(const std::string &, const std::string &): Cannot change group membership on closed socket (call connect() first)");
+    }
+    auto level = this->ipProtocolLevel();
+
+    //MCAST_JOIN_GROUP takes the group as a sockaddr, so one request covers both IPv4 and IPv6
+    addrinfo hints{};
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = (level == IPPROTO_IPV6) ? AF_INET6 : AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_NUMERICHOST;
+    addrinfo *groupInfo{nullptr};
+    auto lookupResult = getaddrinfo(groupAddress.c_str(), nullptr, &hints, &groupInfo);
+    if (lookupResult != 0) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::" + methodName + "(const std::string &, const std::string &): " + groupAddress + " is not a numeric address of the socket's family: " + gai_strerror(lookupResult));
+    }
+    group_req groupRequest{};
+    memset(&groupRequest, 0, sizeof(groupRequest));
+    memcpy(&groupRequest.gr_group, groupInfo->ai_addr, std::min<size_t>(groupInfo->ai_addrlen, sizeof(groupRequest.gr_group)));
+    freeaddrinfo(groupInfo);
+    groupRequest.gr_interface = interfaceIndex(interfaceName);
+
+    auto returnStatus = setsockopt(this->socketDescriptor(), level, join ? MCAST_JOIN_GROUP : MCAST_LEAVE_GROUP, reinterpret_cast<const char *>(&groupRequest), sizeof(groupRequest));
+    if (returnStatus != 0) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UdpSocket::" + methodName + "(const std::string &, const std::string &): setsockopt(int, int, int, const void *, socklen_t): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+}
+
+void UdpSocket::setMulticastInterface(const std::string &interfaceName) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastInterface(const std::string &): Cannot set multicast interface on closed socket (call connect() first)");
+    }
+    auto index = interfaceIndex(interfaceName);
+    int returnStatus{0};
+    if (this->ipProtocolLevel() == IPPROTO_IPV6) {
+        unsigned int interfaceOption{index};
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IPV6, IPV6_MULTICAST_IF, reinterpret_cast<const char *>(&interfaceOption), sizeof(interfaceOption));
+    } else {
+#if defined(_WIN32)
+        //An address of the form 0.0.0.index selects the interface by index
+        DWORD interfaceOption{htonl(index)};
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IP, IP_MULTICAST_IF, reinterpret_cast<const char *>(&interfaceOption), sizeof(interfaceOption));
+#elif defined(__linux__) || defined(__FreeBSD__)
+        ip_mreqn interfaceRequest{};
+        memset(&interfaceRequest, 0, sizeof(interfaceRequest));
+        interfaceRequest.imr_ifindex = static_cast<int>(index);
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IP, IP_MULTICAST_IF, &interfaceRequest, sizeof(interfaceRequest));
+#elif defined(IP_MULTICAST_IFINDEX)
+        unsigned int interfaceOption{index};
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IP, IP_MULTICAST_IFINDEX, &interfaceOption, sizeof(interfaceOption));
+#else
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastInterface(const std::string &): selecting an IPv4 multicast interface by name is not supported on this platform");
+#endif //defined(_WIN32)
+    }
+    if (returnStatus != 0) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastInterface(const std::string &): setsockopt(int, int, int, const void *, socklen_t): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+}
+
+void UdpSocket::setMulticastTtl(int ttl) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastTtl(int): Cannot set multicast TTL on closed socket (call connect() first)");
+    }
+    if ( (ttl < 0) || (ttl > 255) ) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastTtl(int): ttl must be between 0 and 255 (" + std::to_string(ttl) + ")");
+    }
+    int returnStatus{0};
+    if (this->ipProtocolLevel() == IPPROTO_IPV6) {
+        int hops{ttl};
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IPV6, IPV6_MULTICAST_HOPS, reinterpret_cast<const char *>(&hops), sizeof(hops));
+    } else {
+        multicast_option_t timeToLive{static_cast<multicast_option_t>(ttl)};
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<const char *>(&timeToLive), sizeof(timeToLive));
+    }
+    if (returnStatus != 0) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastTtl(int): setsockopt(int, int, int, const void *, socklen_t): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+}
+
+int UdpSocket::multicastTtl() const {
+    if (this->ipProtocolLevel() == IPPROTO_IPV6) {
+        return this->socketOption(IPPROTO_IPV6, IPV6_MULTICAST_HOPS);
+    }
+    return this->socketOption(IPPROTO_IP, IP_MULTICAST_TTL) & 0xFF;
+}
+
+void UdpSocket::setMulticastLoopback(bool loopback) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastLoopback(bool): Cannot set multicast loopback on closed socket (call connect() first)");
+    }
+    int returnStatus{0};
+    if (this->ipProtocolLevel() == IPPROTO_IPV6) {
+        unsigned int loop{loopback ? 1u : 0u};
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IPV6, IPV6_MULTICAST_LOOP, reinterpret_cast<const char *>(&loop), sizeof(loop));
+    } else {
+        multicast_option_t loop{static_cast<multicast_option_t>(loopback ? 1 : 0)};
+        returnStatus = setsockopt(this->socketDescriptor(), IPPROTO_IP, IP_MULTICAST_LOOP, reinterpret_cast<const char *>(&loop), sizeof(loop));
+    }
+    if (returnStatus != 0) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UdpSocket::setMulticastLoopback(bool): setsockopt(int, int, int, const void *, socklen_t): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+}
+
+bool UdpSocket::multicastLoopback() const {
+    if (this->ipProtocolLevel() == IPPROTO_IPV6) {
+        return this->socketOption(IPPROTO_IPV6, IPV6_MULTICAST_LOOP) != 0;
+    }
+    return (this->socketOption(IPPROTO_IP, IP_MULTICAST_LOOP) & 0xFF) != 0;
+}
+
+bool UdpSocket::isMulticastAddress(const std::string &address) {
+    addrinfo hints{};
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_flags = AI_NUMERICHOST;
+    addrinfo *addressList{nullptr};
+    if (getaddrinfo(address.c_str(), nullptr, &hints, &addressList) != 0) {
+        return false;
+    }
+    bool multicast{false};
+    if (addressList->ai_family == AF_INET) {
+        multicast = IN_MULTICAST(ntohl(reinterpret_cast<const sockaddr_in *>(addressList->ai_addr)->sin_addr.s_addr));
+    } else if (addressList->ai_family == AF_INET6) {
+        multicast = IN6_IS_ADDR_MULTICAST(&reinterpret_cast<const sockaddr_in6 *>(addressList->ai_addr)->sin6_addr);
+    }
+    freeaddrinfo(addressList);
+    return multicast;
+}
+
+std::vector<std::unique_ptr<UdpSocket>> UdpSocket::openReusePortGroup(const std::string &hostName, uint16_t portNumber, size_t count, const std::string &interfaceName) {
+    if (count == 0) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::openReusePortGroup(const std::string &, uint16_t, size_t, const std::string &): count must be greater than 0");
+    }
+    auto multicast = isMulticastAddress(hostName);
+    std::vector<std::unique_ptr<UdpSocket>> returnSockets{};
+    returnSockets.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        std::unique_ptr<UdpSocket> udpSocket{new UdpSocket{hostName, portNumber}};
+        udpSocket->setSocketOptions(SocketOptions{}.setReusePort(true));
+        udpSocket->connect();
+#if defined(__linux__)
+        //Linux otherwise hands a wildcard bound socket every group joined by anyone on the host,
+        //which would mix the members' groups together
+        if (udpSocket->ipProtocolLevel() == IPPROTO_IPV6) {
+#    if defined(IPV6_MULTICAST_ALL)
+            udpSocket->setSocketOptions(SocketOptions{}.setOption(IPPROTO_IPV6, IPV6_MULTICAST_ALL, 0, "IPV6_MULTICAST_ALL"));
+#    endif //defined(IPV6_MULTICAST_ALL)
+        } else {
+            udpSocket->setSocketOptions(SocketOptions{}.setOption(IPPROTO_IP, IP_MULTICAST_ALL, 0, "IP_MULTICAST_ALL"));
+        }
+#endif //defined(__linux__)
+        udpSocket->bindSocket(portNumber);
+        if (multicast) {
+            udpSocket->joinGroup(hostName, interfaceName);
+        }
+        returnSockets.push_back(std::move(udpSocket));
+    }
+    return returnSockets;
+}
+
+int UdpSocket::ipProtocolLevel() const {
+    sockaddr_storage localAddress{};
+    socklen_t localAddressLength{sizeof(localAddress)};
+    if (getsockname(this->socketDescriptor(), reinterpret_cast<sockaddr *>(&localAddress), &localAddressLength) != 0) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UdpSocket::ipProtocolLevel(): getsockname(int, sockaddr *, socklen_t *): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    return (localAddress.ss_family == AF_INET6) ? IPPROTO_IPV6 : IPPROTO_IP;
+}
+
+unsigned int UdpSocket::interfaceIndex(const std::string &interfaceName) {
+    if (interfaceName.empty()) {
+        return 0;
+    }
+    auto index = if_nametoindex(interfaceName.c_str());
+    if (index == 0) {
+        throw std::runtime_error("CppSerialPort::UdpSocket::interfaceIndex(const std::string &): no network interface named " + interfaceName);
+    }
+    return static_cast<unsigned int>(index);
+}
+
 void UdpSocket::doConnect() {
 
 }
@@ -45,7 +427,40 @@ ssize_t UdpSocket::doWrite(const char *bytes, size_t byteCount) {
     return sendto(this->socketDescriptor(), bytes, static_cast<int>(byteCount), 0, this->addressInfo()->ai_addr, static_cast<int>(this->addressInfo()->ai_addrlen));
 }
 
+ssize_t UdpSocket::doWrite(const ConstBuffer *buffers, size_t count) {
+#if defined(_WIN32)
+    std::vector<WSABUF> wsaBuffers(count);
+    for (size_t i = 0; i < count; i++) {
+        wsaBuffers[i].buf = const_cast<char *>(buffers[i].data);
+        wsaBuffers[i].len = static_cast<ULONG>(buffers[i].length);
+    }
+    DWORD sentBytes{0};
+    if (WSASendTo(this->socketDescriptor(), wsaBuffers.data(), static_cast<DWORD>(wsaBuffers.size()), &sentBytes, 0, this->addressInfo()->ai_addr, static_cast<int>(this->addressInfo()->ai_addrlen), nullptr, nullptr) == SOCKET_ERROR) {
+        return -1;
+    }
+    return static_cast<ssize_t>(sentBytes);
+#else
+    //The pieces are gathered into a single datagram
+    std::vector<iovec> ioVectors(std::min<size_t>(count, IOV_MAX));
+    for (size_t i = 0; i < ioVectors.size(); i++) {
+        ioVectors[i].iov_base = const_cast<char *>(buffers[i].data);
+        ioVectors[i].iov_len = buffers[i].length;
+    }
+    msghdr message{};
+    message.msg_name = this->addressInfo()->ai_addr;
+    message.msg_namelen = this->addressInfo()->ai_addrlen;
+    message.msg_iov = ioVectors.data();
+    message.msg_iovlen = ioVectors.size();
+    return sendmsg(this->socketDescriptor(), &message, 0);
+#endif //defined(_WIN32)
+}
+
 ssize_t UdpSocket::doRead(char *buffer, size_t bufferMax) {
+#if !defined(_WIN32)
+    if (this->isChunkTimestamping()) {
+        return this->receiveTimestamped(buffer, bufferMax);
+    }
+#endif //!defined(_WIN32)
     return recvfrom(this->socketDescriptor(), buffer, static_cast<int>(bufferMax), 0, nullptr, nullptr);
 }
 
@@ -0,0 +1,183 @@
+#include <CppSerialPort/UnixServer.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+#include <CppSerialPort/DescriptorWaiter.hpp>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using NetworkErrorInformation::getLastError;
+using NetworkErrorInformation::getErrorString;
+
+namespace {
+    bool isAbstractPath(const std::string &path) {
+        return (!path.empty()) && (path[0] == '@');
+    }
+
+#if !defined(__linux__)
+    void setBlocking(int socketDescriptor, bool blocking) {
+        auto flags = fcntl(socketDescriptor, F_GETFL, 0);
+        fcntl(socketDescriptor, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+    }
+#endif //!defined(__linux__)
+}
+
+namespace CppSerialPort {
+
+const int UnixServer::DEFAULT_BACKLOG{SOMAXCONN};
+
+UnixServer::UnixServer(const std::string &path, UnixSocketType type) :
+    m_socketDescriptor{-1},
+    m_path{path},
+    m_type{type},
+    m_backlog{DEFAULT_BACKLOG}
+{
+    UnixSocket::resolvePath(path, type);
+}
+
+UnixServer::~UnixServer() {
+    this->close();
+}
+
+void UnixServer::listen() {
+    if (this->isListening()) {
+        throw std::runtime_error("CppSerialPort::UnixServer::listen(): Already listening (call close() first)");
+    }
+    auto address = UnixSocket::resolvePath(this->m_path, this->m_type);
+    if (!isAbstractPath(this->m_path)) {
+        //Only a leftover socket is removed, never a regular file that happens to share the name
+        struct stat status{};
+        if ( (lstat(this->m_path.c_str(), &status) == 0) && (S_ISSOCK(status.st_mode)) ) {
+            unlink(this->m_path.c_str());
+        }
+    }
+#if defined(__linux__)
+    auto socketDescriptor = socket(address.family, address.socketType | SOCK_NONBLOCK | SOCK_CLOEXEC, address.protocol);
+#else
+    auto socketDescriptor = socket(address.family, address.socketType, address.protocol);
+#endif //defined(__linux__)
+    if (socketDescriptor == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UnixServer::listen(): socket(int, int, int): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    if (bind(socketDescriptor, reinterpret_cast<const sockaddr *>(&address.address), address.addressLength) != 0) {
+        auto errorCode = getLastError();
+        ::close(socketDescriptor);
+        throw std::runtime_error("CppSerialPort::UnixServer::listen(): bind(int, const sockaddr *, socklen_t) to " + this->m_path + ": error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    if (::listen(socketDescriptor, this->m_backlog) != 0) {
+        auto errorCode = getLastError();
+        ::close(socketDescriptor);
+        throw std::runtime_error("CppSerialPort::UnixServer::listen(): listen(int, int): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+#if !defined(__linux__)
+    setBlocking(socketDescriptor, false);
+#endif //!defined(__linux__)
+    this->m_socketDescriptor = socketDescriptor;
+}
+
+void UnixServer::close() {
+    if (!this->isListening()) {
+        return;
+    }
+    ::close(this->m_socketDescriptor);
+    this->m_socketDescriptor = -1;
+    if (!isAbstractPath(this->m_path)) {
+        unlink(this->m_path.c_str());
+    }
+}
+
+bool UnixServer::isListening() const {
+    return (this->m_socketDescriptor != -1);
+}
+
+std::unique_ptr<UnixSocket> UnixServer::accept(std::chrono::steady_clock::time_point deadline) {
+    while (true) {
+        auto acceptedSocket = this->tryAccept();
+        if (acceptedSocket) {
+            return acceptedSocket;
+        }
+        if (!DescriptorWaiter::waitForReadable(this->m_socketDescriptor, deadline)) {
+            return nullptr;
+        }
+    }
+}
+
+std::unique_ptr<UnixSocket> UnixServer::tryAccept() {
+    if (!this->isListening()) {
+        throw std::runtime_error("CppSerialPort::UnixServer::tryAccept(): Cannot accept on a closed server (call listen() first)");
+    }
+    while (true) {
+#if defined(__linux__)
+        //Accepted sockets are left blocking, since UnixSocket waits with poll() and relies on its send and receive timeouts
+        auto acceptedDescriptor = accept4(this->m_socketDescriptor, nullptr, nullptr, SOCK_CLOEXEC);
+#else
+        auto acceptedDescriptor = ::accept(this->m_socketDescriptor, nullptr, nullptr);
+#endif //defined(__linux__)
+        if (acceptedDescriptor == -1) {
+            auto errorCode = getLastError();
+            if ( (errorCode == EINTR) || (errorCode == ECONNABORTED) ) {
+                continue;
+            }
+            if ( (errorCode == EAGAIN) || (errorCode == EWOULDBLOCK) ) {
+                return nullptr;
+            }
+            throw std::runtime_error("CppSerialPort::UnixServer::tryAccept(): accept(int, sockaddr *, socklen_t *): error code " + std::to_string(errorCode) + " (" + getErrorString(errorCode) + ')');
+        }
+#if !defined(__linux__)
+        setBlocking(acceptedDescriptor, true);
+#endif //!defined(__linux__)
+        try {
+            //Clients are almost always unnamed, so the accepted socket is named after the server it came in on
+            return std::unique_ptr<UnixSocket>{new UnixSocket{acceptedDescriptor, this->m_type, this->m_path}};
+        } catch (std::exception &e) {
+            (void)e;
+            ::close(acceptedDescriptor);
+            throw;
+        }
+    }
+}
+
+std::vector<std::unique_ptr<UnixSocket>> UnixServer::acceptPending() {
+    std::vector<std::unique_ptr<UnixSocket>> acceptedSockets{};
+    while (true) {
+        auto acceptedSocket = this->tryAccept();
+        if (!acceptedSocket) {
+            break;
+        }
+        acceptedSockets.push_back(std::move(acceptedSocket));
+    }
+    return acceptedSockets;
+}
+
+void UnixServer::setBacklog(int backlog) {
+    if (backlog <= 0) {
+        throw std::runtime_error("CppSerialPort::UnixServer::setBacklog(int): backlog must be greater than 0 (" + std::to_string(backlog) + " <= 0)");
+    }
+    this->m_backlog = backlog;
+    if (this->isListening()) {
+        ::listen(this->m_socketDescriptor, this->m_backlog);
+    }
+}
+
+int UnixServer::backlog() const {
+    return this->m_backlog;
+}
+
+std::string UnixServer::path() const {
+    return this->m_path;
+}
+
+UnixSocketType UnixServer::type() const {
+    return this->m_type;
+}
+
+int UnixServer::fileDescriptor() const {
+    return this->m_socketDescriptor;
+}
+
+} //namespace CppSerialPort
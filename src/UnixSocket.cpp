@@ -0,0 +1,289 @@
+#include <CppSerialPort/UnixSocket.hpp>
+#include <CppSerialPort/ErrorInformation.hpp>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+using NetworkErrorInformation::getLastError;
+using NetworkErrorInformation::getErrorString;
+
+namespace {
+#if defined(MSG_NOSIGNAL)
+    //A peer that has gone away is reported as EPIPE instead of killing the process with SIGPIPE
+    const int SEND_FLAGS{MSG_NOSIGNAL};
+#else
+    const int SEND_FLAGS{0};
+#endif //defined(MSG_NOSIGNAL)
+
+    int toSocketType(CppSerialPort::UnixSocketType type) {
+        return (type == CppSerialPort::UnixSocketType::SeqPacket) ? SOCK_SEQPACKET : SOCK_STREAM;
+    }
+}
+
+namespace CppSerialPort {
+
+//SCM_MAX_FD on Linux
+const size_t UnixSocket::MAXIMUM_DESCRIPTORS_PER_MESSAGE{253};
+
+UnixSocket::UnixSocket(const std::string &path, UnixSocketType type) :
+    AbstractSocket{path},
+    m_path{path},
+    m_type{type}
+{
+    //Checked now, so a bad path fails here instead of at connect()
+    resolvePath(path, type);
+}
+
+UnixSocket::UnixSocket(socket_t connectedDescriptor, UnixSocketType type, const std::string &path) :
+    UnixSocket{connectedDescriptor, type, path, resolvePath(path, type)}
+{
+
+}
+
+UnixSocket::UnixSocket(socket_t connectedDescriptor, UnixSocketType type, const std::string &path, const ResolvedAddress &address) :
+    AbstractSocket{connectedDescriptor, reinterpret_cast<const sockaddr *>(&address.address), address.addressLength},
+    m_path{path},
+    m_type{type}
+{
+
+}
+
+std::pair<std::unique_ptr<UnixSocket>, std::unique_ptr<UnixSocket>> UnixSocket::createPair(UnixSocketType type) {
+    int socketDescriptors[2]{-1, -1};
+#if defined(SOCK_CLOEXEC)
+    auto pairResult = socketpair(AF_UNIX, toSocketType(type) | SOCK_CLOEXEC, 0, socketDescriptors);
+#else
+    auto pairResult = socketpair(AF_UNIX, toSocketType(type), 0, socketDescriptors);
+#endif //defined(SOCK_CLOEXEC)
+    if (pairResult == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UnixSocket::createPair(UnixSocketType): socketpair(int, int, int, int *): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    std::unique_ptr<UnixSocket> first{nullptr};
+    try {
+        first.reset(new UnixSocket{socketDescriptors[0], type, "@socketpair"});
+    } catch (std::exception &e) {
+        (void)e;
+        close(socketDescriptors[0]);
+        close(socketDescriptors[1]);
+        throw;
+    }
+    std::unique_ptr<UnixSocket> second{nullptr};
+    try {
+        second.reset(new UnixSocket{socketDescriptors[1], type, "@socketpair"});
+    } catch (std::exception &e) {
+        (void)e;
+        close(socketDescriptors[1]);
+        throw;
+    }
+    return std::make_pair(std::move(first), std::move(second));
+}
+
+ResolvedAddress UnixSocket::resolvePath(const std::string &path, UnixSocketType type) {
+    sockaddr_un unixAddress{};
+    memset(&unixAddress, 0, sizeof(unixAddress));
+    unixAddress.sun_family = AF_UNIX;
+    if (path.empty()) {
+        throw std::runtime_error("CppSerialPort::UnixSocket::resolvePath(const std::string &, UnixSocketType): path cannot be empty");
+    }
+    //Abstract names are not NUL terminated: every byte after the leading NUL is part of the name
+    auto isAbstract = (path[0] == '@');
+    auto pathLength = path.length() + (isAbstract ? 0 : 1);
+    if (pathLength > sizeof(unixAddress.sun_path)) {
+        throw std::runtime_error("CppSerialPort::UnixSocket::resolvePath(const std::string &, UnixSocketType): path " + path + " is too long (" + toStdString(path.length()) + " > " + toStdString(sizeof(unixAddress.sun_path) - 1) + ')');
+    }
+    memcpy(unixAddress.sun_path, path.data(), path.length());
+    if (isAbstract) {
+        unixAddress.sun_path[0] = '\0';
+    }
+    ResolvedAddress returnValue{};
+    returnValue.family = AF_UNIX;
+    returnValue.socketType = toSocketType(type);
+    returnValue.protocol = 0;
+    memset(&returnValue.address, 0, sizeof(returnValue.address));
+    memcpy(&returnValue.address, &unixAddress, sizeof(unixAddress));
+    returnValue.addressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + pathLength);
+    return returnValue;
+}
+
+std::string UnixSocket::portName() const {
+    return "[unix:" + this->m_path + ']';
+}
+
+std::string UnixSocket::path() const {
+    return this->m_path;
+}
+
+bool UnixSocket::isAbstract() const {
+    return (!this->m_path.empty()) && (this->m_path[0] == '@');
+}
+
+UnixSocketType UnixSocket::type() const {
+    return this->m_type;
+}
+
+ssize_t UnixSocket::writeWithDescriptors(const char *bytes, size_t byteCount, const std::vector<int> &descriptors) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UnixSocket::writeWithDescriptors(const char *, size_t, const std::vector<int> &): Cannot write on closed socket (call connect first)");
+    }
+    if (byteCount == 0) {
+        throw std::runtime_error("CppSerialPort::UnixSocket::writeWithDescriptors(const char *, size_t, const std::vector<int> &): At least one byte must be sent with the descriptors");
+    }
+    if (descriptors.size() > MAXIMUM_DESCRIPTORS_PER_MESSAGE) {
+        throw std::runtime_error("CppSerialPort::UnixSocket::writeWithDescriptors(const char *, size_t, const std::vector<int> &): Too many descriptors (" + toStdString(descriptors.size()) + " > " + toStdString(MAXIMUM_DESCRIPTORS_PER_MESSAGE) + ')');
+    }
+    if (descriptors.empty()) {
+        return this->write(bytes, byteCount);
+    }
+    iovec ioVector{const_cast<char *>(bytes), byteCount};
+    std::vector<char> control(CMSG_SPACE(descriptors.size() * sizeof(int)));
+    msghdr message{};
+    message.msg_iov = &ioVector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    auto controlMessage = CMSG_FIRSTHDR(&message);
+    controlMessage->cmsg_level = SOL_SOCKET;
+    controlMessage->cmsg_type = SCM_RIGHTS;
+    controlMessage->cmsg_len = CMSG_LEN(descriptors.size() * sizeof(int));
+    memcpy(CMSG_DATA(controlMessage), descriptors.data(), descriptors.size() * sizeof(int));
+
+    ssize_t sendResult{-1};
+    do {
+        sendResult = sendmsg(this->socketDescriptor(), &message, SEND_FLAGS);
+    } while ( (sendResult == -1) && (getLastError() == EINTR) );
+    if (sendResult == -1) {
+        auto errorCode = getLastError();
+        if ( (errorCode == ENOTCONN) || (errorCode == EPIPE) || (errorCode == ECONNRESET) ) {
+            this->closePort();
+            throw SocketDisconnectedException{this->portName(), "CppSerialPort::UnixSocket::writeWithDescriptors(): The server hung up unexpectedly"};
+        }
+        throw std::runtime_error("CppSerialPort::UnixSocket::writeWithDescriptors(const char *, size_t, const std::vector<int> &): sendmsg(int, const msghdr *, int): error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+    //The descriptors went with the first byte, so the rest of a short send is just bytes
+    if (static_cast<size_t>(sendResult) < byteCount) {
+        sendResult += this->write(bytes + sendResult, byteCount - static_cast<size_t>(sendResult));
+    }
+    return sendResult;
+}
+
+size_t UnixSocket::readWithDescriptors(char *buffer, size_t maximum, std::vector<int> *descriptors, std::chrono::steady_clock::time_point deadline) {
+    if (!this->isConnected()) {
+        throw std::runtime_error("CppSerialPort::UnixSocket::readWithDescriptors(char *, size_t, std::vector<int> *, std::chrono::steady_clock::time_point): Cannot read on closed socket (call connect first)");
+    }
+    if (descriptors) {
+        descriptors->clear();
+    }
+    if (maximum == 0) {
+        return 0;
+    }
+    //Bytes already buffered were read without their descriptors, which the kernel closed at the time
+    if (!this->readBuffer().empty()) {
+        return this->readBuffer().read(buffer, maximum);
+    }
+    if (!this->waitForReadable(deadline)) {
+        return 0;
+    }
+    iovec ioVector{buffer, maximum};
+    std::vector<char> control(CMSG_SPACE(MAXIMUM_DESCRIPTORS_PER_MESSAGE * sizeof(int)));
+    msghdr message{};
+    message.msg_iov = &ioVector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+#if defined(MSG_CMSG_CLOEXEC)
+    const int receiveFlags{MSG_CMSG_CLOEXEC};
+#else
+    const int receiveFlags{0};
+#endif //defined(MSG_CMSG_CLOEXEC)
+    ssize_t receiveResult{-1};
+    do {
+        receiveResult = recvmsg(this->socketDescriptor(), &message, receiveFlags);
+    } while ( (receiveResult == -1) && (getLastError() == EINTR) );
+    for (auto controlMessage = CMSG_FIRSTHDR(&message); controlMessage != nullptr; controlMessage = CMSG_NXTHDR(&message, controlMessage)) {
+        if ( (controlMessage->cmsg_level != SOL_SOCKET) || (controlMessage->cmsg_type != SCM_RIGHTS) ) {
+            continue;
+        }
+        auto descriptorCount = (controlMessage->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        std::vector<int> received(descriptorCount);
+        memcpy(received.data(), CMSG_DATA(controlMessage), descriptorCount * sizeof(int));
+        for (auto it : received) {
+            if (descriptors) {
+                descriptors->push_back(it);
+            } else {
+                close(it);
+            }
+        }
+    }
+    if (receiveResult == -1) {
+        auto errorCode = getLastError();
+        if ( (errorCode == EAGAIN) || (errorCode == EWOULDBLOCK) ) {
+            return 0;
+        }
+        this->closePort();
+        throw SocketDisconnectedException{this->portName(), "CppSerialPort::UnixSocket::readWithDescriptors(): The server hung up unexpectedly"};
+    } else if (receiveResult == 0) {
+        this->closePort();
+        throw SocketDisconnectedException{this->portName(), "CppSerialPort::UnixSocket::readWithDescriptors(): The server hung up unexpectedly"};
+    }
+    return static_cast<size_t>(receiveResult);
+}
+
+void UnixSocket::doConnect() {
+    //A local connect either completes or fails at once, so there is nothing to wait for
+    int connectResult{-1};
+    do {
+        connectResult = ::connect(this->socketDescriptor(), this->addressInfo()->ai_addr, this->addressInfo()->ai_addrlen);
+    } while ( (connectResult == -1) && (getLastError() == EINTR) );
+    if (connectResult == -1) {
+        auto errorCode = getLastError();
+        throw std::runtime_error("CppSerialPort::UnixSocket::doConnect(): connect(int, sockaddr *, socklen_t) to " + this->m_path + " failed with error code " + toStdString(errorCode) + " (" + getErrorString(errorCode) + ')');
+    }
+}
+
+addrinfo UnixSocket::getAddressInfoHints() {
+    addrinfo hints{0, 0, 0, 0, 0, nullptr, nullptr, nullptr};
+    memset(reinterpret_cast<void *>(&hints), 0, sizeof(addrinfo));
+    hints.ai_family = AF_UNIX;
+    hints.ai_socktype = toSocketType(this->m_type);
+    return hints;
+}
+
+std::shared_ptr<const std::vector<ResolvedAddress>> UnixSocket::resolveAddresses(const addrinfo &hints) {
+    (void)hints;
+    //Nothing to look up: the path is the address
+    return std::make_shared<const std::vector<ResolvedAddress>>(1, resolvePath(this->m_path, this->m_type));
+}
+
+ssize_t UnixSocket::doWrite(const char *bytes, size_t byteCount) {
+    return send(this->socketDescriptor(), bytes, byteCount, SEND_FLAGS);
+}
+
+ssize_t UnixSocket::doWrite(const ConstBuffer *buffers, size_t count) {
+    std::vector<iovec> ioVectors(std::min<size_t>(count, IOV_MAX));
+    for (size_t i = 0; i < ioVectors.size(); i++) {
+        ioVectors[i].iov_base = const_cast<char *>(buffers[i].data);
+        ioVectors[i].iov_len = buffers[i].length;
+    }
+    msghdr message{};
+    message.msg_iov = ioVectors.data();
+    message.msg_iovlen = ioVectors.size();
+    return sendmsg(this->socketDescriptor(), &message, SEND_FLAGS);
+}
+
+ssize_t UnixSocket::doRead(char *buffer, size_t bufferMax) {
+    if (this->isChunkTimestamping()) {
+        return this->receiveTimestamped(buffer, bufferMax);
+    }
+    return recv(this->socketDescriptor(), buffer, bufferMax, 0);
+}
+
+} //namespace CppSerialPort